@@ -6,9 +6,6 @@
 #include <WebServer.h>
 #include <SPIFFS.h>
 
-// Toggle Debug Mode here
-#define MINISERV_DEBUGMODE 1
-
 class MiniServ
 {
 public:
@@ -37,8 +34,8 @@ public:
     //initializes the webserver
     void InitWebServer(int port=80, int client_timeout=2000);
 
-    //Checks if there is an inbound client request
-    void HandleClientRequests();
+    //Checks if there is an inbound client request, returns true if one was handled (responded to or uploaded)
+    bool HandleClientRequests();
 
     //Gets the raw response headers
     String GetRequestHeaders();
@@ -73,6 +70,15 @@ public:
     //Sends a binary file to the Web Client
     void SendBinaryFileResponse(const char *filePath, int responseCode, String contentType);
 
+    //Starts a chunked response of unknown length to the Web Client
+    void BeginChunkedResponse(int responseCode, String contentType);
+
+    //Sends the next chunk of a chunked response
+    void SendResponseChunk(String chunk);
+
+    //Terminates a chunked response
+    void EndChunkedResponse();
+
     //Sends a 404 Not Found to the Web Client, optionally with a body
     void SendNotFound(String htmlBody="");
 
@@ -93,6 +99,7 @@ private:
     bool _isWiFiConnected = false;
     File uploadFile;
     bool _isAPConnected = false;
+    bool _requestHandled = false;
     
     //Parse raw headers to get path
     String ParseRequestHeaderPath(String headers);
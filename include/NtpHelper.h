@@ -2,6 +2,23 @@
 #define ntphelper_h
 
 #include <Arduino.h>
+#include <time.h>
+
+//Use the following definitions:
+//Default POSIX timezone (see https://github.com/nayarsystems/posix_tz_db)
+//      #define NTP_DEFAULT_TIMEZONE    "EST5EDT,M3.2.0,M11.1.0"
+//
+//How often the cached time base is re-anchored on the system clock, in milliseconds
+//      #define NTP_RESYNC_MS           60000
+//
+
+#ifndef NTP_DEFAULT_TIMEZONE
+#define NTP_DEFAULT_TIMEZONE    "EST5EDT,M3.2.0,M11.1.0"
+#endif
+
+#ifndef NTP_RESYNC_MS
+#define NTP_RESYNC_MS           60000
+#endif
 
 class NtpHelper
 {
@@ -13,7 +30,10 @@ public:
     NtpHelper();
 
     //Public functions
-    void ConfigNTP(String NTPserver1="pool.ntp.org", String NTPserver2="time.google.com", String NTPserver3="time.cloudflare.com");
+    void ConfigNTP(String NTPserver1="pool.ntp.org", String NTPserver2="time.google.com", String NTPserver3="time.cloudflare.com", String timezone=NTP_DEFAULT_TIMEZONE);
+    bool IsTimeSet();
+    time_t Now();
+    bool GetLocalClock(int &hours, int &minutes, int &seconds);
     String GetTime();
     String GetDateTime();
     String GetDate();
@@ -21,7 +41,13 @@ public:
 
 private:
     //private members
-    
+    String _servers[3];                 //kept alive, SNTP keeps the pointers
+    String _timezone;
+    time_t _baseEpoch;                  //system time at the anchor
+    unsigned long _baseMillis;          //millis() at the anchor
+    long _baseSecondsOfDay;             //local seconds since midnight at the anchor
+
+    bool Anchor();
 };
 
-#endif
\ No newline at end of file
+#endif
@@ -2,6 +2,10 @@
 #define fastledutils_h
 
 #include <Arduino.h>
+#include <FastLED.h>
+#include <ledpattern.h>
+#include <ledimage.h>
+#include <imagepack.h>
 
 //Use the following definitions:
 //LED Matrix width - width of your strip(s)
@@ -13,7 +17,7 @@
 //Total number of LEDs - should be calculated unless this is an exception case
 //      #define LED_NUM_LEDS            (LED_MATRIX_WIDTH*LED_MATRIX_HEIGHT)
 //
-//Is LED Matrix interlaced? - Set to 1 the first row goes one way and the next the other way
+//Is LED Matrix interlaced? - Set to 1 the first row goes right to left and the next left to right, and so on
 //      #define LED_MATRIX_INTERLACED   0
 //
 //LED GPIO pin to use for data
@@ -22,6 +26,23 @@
 //LED Strip resolution in Pixels per Meter - how  many LEDs you have per meter - essential for speed calculation
 //      #define LED_PX_PER_METER        60
 //
+//Life effect: percentage of live cells when seeding
+//      #define LED_LIFE_DENSITY        35
+//
+//Life effect: generations without progress before reseeding
+//      #define LED_LIFE_STAGNANT_GENERATIONS   48
+//
+//Life effect: number of past generations compared to detect oscillators
+//      #define LED_LIFE_HISTORY        4
+//
+//Fire effect: how fast the flames cool down and how often new sparks ignite (0-255)
+//      #define LED_FIRE_COOLING        55
+//      #define LED_FIRE_SPARKING       120
+//
+//Noise effect: zoom (8.8 fixed point step per LED) and how fast the field changes
+//      #define LED_NOISE_SCALE         40
+//      #define LED_NOISE_SPEED         8
+//
 
 
 
@@ -31,12 +52,36 @@ void InitLED();
 //Sets which effect should be displayed, optionally choosing parameters
 void SetLEDCurrentEffect(String effect, String parameters="");
 
+//Displays an already compiled pattern (e.g. a built-in preset), pattern must stay valid
+void SetLEDPatternEffect(const LedPattern *pattern);
+
 //Gets which effect is currently displayed
 String GetLEDCurrentEffect();
 
 //Gets parameter for current effect displayed
 String GetLEDCurrentEffectParameters();
 
+//Sets how images are fitted onto the matrix
+void SetLEDImageMode(LedImageMode mode);
+
+//Gets how images are fitted onto the matrix
+LedImageMode GetLEDImageMode();
+
+//Sets the image pack the pack effect draws from (mapped, must stay valid)
+void SetLEDImagePack(const ImagePack &pack);
+
+//Gets the image pack the pack effect draws from, empty if none
+const ImagePack &GetLEDImagePack();
+
+//Sets the colour of the text effect
+void SetLEDTextColor(CRGB color);
+
+//Sets whether the pattern effect scrolls one pixel per frame
+void SetLEDPatternScroll(bool scroll);
+
+//Gets whether the pattern effect scrolls one pixel per frame
+bool GetLEDPatternScroll();
+
 //Sets the speed which leds should travel in meters per second
 void SetLEDTravelSpeed(float speed_m_per_s);
 
@@ -0,0 +1,21 @@
+#ifndef fxutils_h
+#define fxutils_h
+
+#include <stdint.h>
+
+//Plain C++ (no Arduino dependency) so it can be compiled and benchmarked on the host.
+//Grids are row major, row 0 at the top.
+
+//Advances a fire simulation: heat rises from the bottom row, cooling and sparking 0-255
+void FireStep(uint8_t *heat, int width, int height, uint8_t cooling, uint8_t sparking, uint32_t &rng);
+
+//3D gradient noise on 8.8 fixed point coordinates, returns 0-255 (inoise8 style)
+uint8_t Noise8(uint16_t x, uint16_t y, uint16_t z);
+
+//Fills a grid with noise, stepping scale (8.8) per cell from (x, y) at depth z
+void NoiseFill(uint8_t *values, int width, int height, uint16_t x, uint16_t y, uint16_t z, uint16_t scale);
+
+//Fills rows [first, last) of a grid like NoiseFill does, so row jobs match a whole fill
+void NoiseFillRows(uint8_t *values, int width, int first, int last, uint16_t x, uint16_t y, uint16_t z, uint16_t scale);
+
+#endif
@@ -0,0 +1,18 @@
+#ifndef hexutils_h
+#define hexutils_h
+
+#include <stddef.h>
+#include <stdint.h>
+
+//Plain C++ (no Arduino dependency) so it can be compiled and benchmarked on the host.
+
+//Decodes hexadecimal text into bytes, 8 characters at a time
+//  returns the number of bytes written, or -1 if the text is not valid hexadecimal,
+//  has an odd length or does not fit; errorPos receives the offset of the offending character
+int HexDecode(const char *hex, size_t hexLength, uint8_t *out, size_t outSize, int *errorPos=NULL);
+
+//Decodes RRGGBB hexadecimal text into 3 byte pixels (CRGB layout)
+//  returns the number of pixels written, or -1 on error (see HexDecode)
+int HexDecodePixels(const char *hex, size_t hexLength, uint8_t *rgb, size_t maxPixels, int *errorPos=NULL);
+
+#endif
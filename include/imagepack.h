@@ -0,0 +1,76 @@
+#ifndef imagepack_h
+#define imagepack_h
+
+#include <stddef.h>
+#include <stdint.h>
+
+//Plain C++ (no Arduino dependency) so packs can be read and checked on the host.
+
+//Use the following definitions:
+//Map the image pack partition at startup (needs a partition table with an "imgpack" data partition)
+//      #define LED_IMAGE_PACK          0
+//
+
+#ifndef LED_IMAGE_PACK
+#define LED_IMAGE_PACK          0
+#endif
+
+//Largest image accepted from a pack, the decoded image limit (see ledimage.h)
+#ifndef LED_IMAGE_MAX_PIXELS
+#define LED_IMAGE_MAX_PIXELS    4096
+#endif
+
+#define IMAGE_PACK_PARTITION    "imgpack"   //label of the flash partition
+#define IMAGE_PACK_NAME         24          //longest image name
+#define IMAGE_PACK_VERSION      1
+
+//Image pack layout (little endian), built by tools/mkimgpack.py:
+//  header  "LIPK", version (16 bits), image count (16 bits), pack size (32 bits), reserved (32 bits)
+//  index   per image: name (24 bytes, NUL padded), width, height, frames, flags (16 bits each),
+//          offset of the frame durations (32 bits, 0 for stills), offset of the pixels (32 bits)
+//  data    frame durations in ms (16 bits each)
+//          pixels as RGB bytes (CRGB layout), frame after frame, row order from the top left corner
+
+//Image pack mapped in memory
+struct ImagePack
+{
+    const uint8_t   *data;
+    size_t          size;
+    uint16_t        count;
+};
+
+//Image of a pack, pixels point into the pack
+struct ImagePackEntry
+{
+    char            name[IMAGE_PACK_NAME + 1];
+    uint16_t        width;
+    uint16_t        height;
+    uint16_t        frames;
+    const uint8_t   *durations;     //NULL for stills
+    const uint8_t   *pixels;        //first frame
+};
+
+//Checks a pack and its whole index, returns false if anything points outside of it
+bool OpenImagePack(const uint8_t *data, size_t size, ImagePack &pack);
+
+//Gets the index of an image by name, -1 if not in the pack
+int FindImagePackEntry(const ImagePack &pack, const char *name);
+
+//Gets an image of the pack by index
+bool GetImagePackEntry(const ImagePack &pack, int index, ImagePackEntry &entry);
+
+//Gets the RGB pixels of a frame
+const uint8_t *GetImagePackFrame(const ImagePackEntry &entry, int frame);
+
+//Gets the duration of a frame in ms, 0 for stills
+uint16_t GetImagePackDuration(const ImagePackEntry &entry, int frame);
+
+#ifdef ESP32
+//Maps the image pack partition into the address space (read only, no copy)
+bool MapImagePackPartition(ImagePack &pack);
+#else
+//Maps an image pack file (host)
+bool MapImagePackFile(const char *path, ImagePack &pack);
+#endif
+
+#endif
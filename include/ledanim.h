@@ -0,0 +1,76 @@
+#ifndef ledanim_h
+#define ledanim_h
+
+#include <Arduino.h>
+#include <FastLED.h>
+#include <ledimage.h>
+
+//Use the following definitions:
+//Largest animation frame in pixels (each ring buffer holds one frame)
+//      #define LED_ANIM_MAX_PIXELS     1024
+//
+//Number of frames decoded ahead of the one displayed, plus one
+//      #define LED_ANIM_BUFFERS        2
+//
+//Characters read from the file at once while decoding a frame (multiple of 6)
+//      #define LED_ANIM_CHUNK          384
+//
+//Keyframes remembered to play delta-encoded animations backwards (ping-pong), even number;
+//files with more keep every 2nd, 4th... keyframe: a backward step then replays up to that
+//many keyframe intervals of records instead of one
+//      #define LED_ANIM_KEYFRAMES      32
+//
+
+#ifndef LED_ANIM_MAX_PIXELS
+#define LED_ANIM_MAX_PIXELS     1024
+#endif
+
+#ifndef LED_ANIM_BUFFERS
+#define LED_ANIM_BUFFERS        2
+#endif
+
+#ifndef LED_ANIM_CHUNK
+#define LED_ANIM_CHUNK          384
+#endif
+
+#ifndef LED_ANIM_KEYFRAMES
+#define LED_ANIM_KEYFRAMES      32
+#endif
+
+//Animated image files:
+//  "@A<width>,<height>,<frames>;" followed by one record per frame,
+//  each record being the frame duration in ms as 4 hexadecimal digits
+//  then width*height RRGGBB pixels. Records have a fixed size so any frame
+//  can be read directly.
+//
+//Delta-encoded animated image files:
+//  "@D<width>,<height>,<frames>;" followed by one record per frame, either
+//      "K" <duration> then width*height RRGGBB pixels (keyframe, the first frame must be one)
+//      "D" <duration> <length> then skip/run pairs, <length> being the number of
+//          characters of the pairs as 6 hexadecimal digits
+//  each pair being the pixels left unchanged and the pixels replaced as 2 hexadecimal
+//  digits each, then the replacing RRGGBB pixels. A delta applies to the previous frame.
+
+//Gets whether a file of the image store is an animation
+bool IsLEDAnimationFile(String filePath);
+
+//Opens an animation, returns false if not valid
+bool StartLEDAnimation(String filePath);
+
+//Closes the animation file
+void StopLEDAnimation();
+
+//Draws the next frame onto the matrix when it is due, returns true if the LEDs changed
+//  also decodes at most one frame ahead per call, to spread the file reads
+bool UpdateLEDAnimation(unsigned long now, CRGB *target, LedImageMode mode);
+
+//Sets whether the animation starts over after its last frame
+void SetLEDAnimationLoop(bool loop);
+
+//Sets whether the animation plays back and forth instead of starting over
+void SetLEDAnimationPingPong(bool pingpong);
+
+//Sets a frame rate overriding the durations of the file, 0 to use the file durations
+void SetLEDAnimationFps(int fps);
+
+#endif
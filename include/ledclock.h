@@ -0,0 +1,22 @@
+#ifndef ledclock_h
+#define ledclock_h
+
+#include <Arduino.h>
+#include <FastLED.h>
+
+//Shows or hides the clock overlay
+void SetLEDClockEnabled(bool enabled);
+
+//Gets whether the clock overlay is shown
+bool GetLEDClockEnabled();
+
+//Sets the colour of the clock digits
+void SetLEDClockColor(CRGB color);
+
+//Sets whether the seconds are shown (as a bar on the bottom row)
+void SetLEDClockSeconds(bool seconds);
+
+//Redraws the clock overlay if the displayed time changed - to be added to the main loop
+void UpdateLEDClock(int hours, int minutes, int seconds);
+
+#endif
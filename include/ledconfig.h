@@ -0,0 +1,59 @@
+#ifndef ledconfig_h
+#define ledconfig_h
+
+//Default LED hardware definitions shared by the LED modules,
+//override them with build flags (see fastledutils.h for their meaning)
+
+#ifndef LED_MATRIX_WIDTH
+#define LED_MATRIX_WIDTH        16
+#endif
+
+#ifndef LED_MATRIX_HEIGHT
+#define LED_MATRIX_HEIGHT       16
+#endif
+
+#ifndef LED_NUM_LEDS
+#define LED_NUM_LEDS            (LED_MATRIX_WIDTH*LED_MATRIX_HEIGHT)
+#endif
+
+#ifndef LED_MATRIX_INTERLACED
+#define LED_MATRIX_INTERLACED   0
+#endif
+
+#ifndef LED_GPIO_PIN
+#define LED_GPIO_PIN            13
+#endif
+
+#ifndef LED_PX_PER_METER
+#define LED_PX_PER_METER        60
+#endif
+
+#ifndef LED_LIFE_DENSITY
+#define LED_LIFE_DENSITY        35
+#endif
+
+#ifndef LED_LIFE_STAGNANT_GENERATIONS
+#define LED_LIFE_STAGNANT_GENERATIONS   48
+#endif
+
+#ifndef LED_LIFE_HISTORY
+#define LED_LIFE_HISTORY        4
+#endif
+
+#ifndef LED_FIRE_COOLING
+#define LED_FIRE_COOLING        55
+#endif
+
+#ifndef LED_FIRE_SPARKING
+#define LED_FIRE_SPARKING       120
+#endif
+
+#ifndef LED_NOISE_SCALE
+#define LED_NOISE_SCALE         40
+#endif
+
+#ifndef LED_NOISE_SPEED
+#define LED_NOISE_SPEED         8
+#endif
+
+#endif
@@ -0,0 +1,17 @@
+#ifndef ledfont_h
+#define ledfont_h
+
+#include <stdint.h>
+
+//Glyph size of the built-in font, in pixels
+#define LED_FONT_WIDTH          3
+#define LED_FONT_HEIGHT         5
+
+//Gets the rows of a glyph, top first, bit 2 being the leftmost column
+//  returns NULL for characters the font does not have
+const uint8_t *GetLEDFontGlyph(char c);
+
+//Gets whether a glyph pixel is lit
+bool GetLEDFontPixel(const uint8_t *glyph, int x, int y);
+
+#endif
@@ -0,0 +1,44 @@
+#ifndef ledgovernor_h
+#define ledgovernor_h
+
+#include <Arduino.h>
+
+//Use the following definitions:
+//Adapt the frame period to the measured frame cost (0 to always use the requested framerate)
+//      #define LED_GOVERNOR_ENABLED    1
+//
+//Share of the frame period an effect may use before the frame rate is lowered (%)
+//      #define LED_GOVERNOR_LOAD       80
+//
+//Share of the frame period under which the frame rate recovers toward the requested one (%)
+//      #define LED_GOVERNOR_RECOVER    50
+//
+
+#ifndef LED_GOVERNOR_ENABLED
+#define LED_GOVERNOR_ENABLED    1
+#endif
+
+#ifndef LED_GOVERNOR_LOAD
+#define LED_GOVERNOR_LOAD       80
+#endif
+
+#ifndef LED_GOVERNOR_RECOVER
+#define LED_GOVERNOR_RECOVER    50
+#endif
+
+//Forgets the measurements, the next effect starts at its requested framerate
+void ResetLEDGovernor();
+
+//Records the cost of a frame in us, returns the frame period to use in ms (at least the requested one)
+long UpdateLEDGovernor(unsigned long frameTime, long requestedPeriod);
+
+//Gets the frame period chosen in ms
+long GetLEDGovernorPeriod();
+
+//Gets the average frame cost of the current effect in us
+unsigned long GetLEDGovernorFrameTime();
+
+//Gets how many frames of the current effect took longer than the requested period
+unsigned long GetLEDGovernorOverruns();
+
+#endif
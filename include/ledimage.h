@@ -0,0 +1,65 @@
+#ifndef ledimage_h
+#define ledimage_h
+
+#include <Arduino.h>
+#include <FastLED.h>
+
+//Use the following definitions:
+//Largest source image in pixels, sizes the decoding buffer (3 bytes per pixel)
+//      #define LED_IMAGE_MAX_PIXELS    4096
+//
+
+#ifndef LED_IMAGE_MAX_PIXELS
+#define LED_IMAGE_MAX_PIXELS    4096
+#endif
+
+//How an image is fitted onto the matrix
+enum LedImageMode
+{
+    LED_IMAGE_NEAREST,          //stretch to the matrix, nearest neighbour
+    LED_IMAGE_BILINEAR,         //stretch to the matrix, bilinear filtering
+    LED_IMAGE_CENTER,           //original size, centred and cropped
+    LED_IMAGE_TILE              //original size, repeated from the top left corner
+};
+
+//Decoded image, pixels in row order from the top left corner
+struct LedImage
+{
+    uint16_t    width;
+    uint16_t    height;
+    CRGB        *pixels;
+};
+
+//Decodes image data into image.pixels (capacity in pixels)
+//  data is one of:
+//      RRGGBB hexadecimal, optionally preceded by a "@I<width>,<height>;" header;
+//          without header the image must be square or as wide as the matrix
+//      "@P<width>,<height>,<colors>;" then the RRGGBB palette (at most 256 colours) then
+//          the palette index of every pixel, as one hexadecimal digit up to 16 colours
+//          (padded to an even count) or two digits above
+//      "@R<width>,<height>,<colors>;" then the RRGGBB palette then runs, each run being
+//          its length minus one and its palette index as two hexadecimal digits each
+//  returns false on error, errorPos receives the offset of the offending character
+bool DecodeLEDImage(const char *data, size_t length, LedImage &image, size_t capacity, int *errorPos=NULL);
+
+//Gets the number of pixels of a stored image from its header (plain RRGGBB without one: length / 6),
+//  0 if the header is malformed or the image larger than LED_IMAGE_MAX_PIXELS
+size_t GetLEDImagePixelCount(const char *data, size_t length);
+
+//Encodes an image in the smallest of the representations above, empty if out of memory
+String EncodeLEDImage(const LedImage &image);
+
+//Gets the length of a stored image (or animation) as plain RRGGBB hexadecimal, from its first characters
+//  fileLength is returned when the header does not tell
+size_t GetLEDImageRawLength(const char *data, size_t length, size_t fileLength);
+
+//Draws an image onto a matrix sized LED array, using integer arithmetic only
+void BlitLEDImage(const LedImage &image, CRGB *target, LedImageMode mode);
+
+//Gets the image mode matching a name (nearest, bilinear, center, tile), nearest if unknown
+LedImageMode ParseLEDImageMode(String name);
+
+//Gets the name of an image mode
+const char *GetLEDImageModeName(LedImageMode mode);
+
+#endif
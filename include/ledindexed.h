@@ -0,0 +1,37 @@
+#ifndef ledindexed_h
+#define ledindexed_h
+
+#include <Arduino.h>
+#include <FastLED.h>
+
+//Indexed frame: one palette index per LED (strip order) and a 256 colour palette,
+//expanded to CRGB only on output. Rotating the palette animates the whole frame
+//without touching a single pixel.
+//The frame adds LED_NUM_LEDS + 768 bytes on top of the LED array; overlay layers
+//stay CRGB with alpha (see ledlayers.h), they are blended per pixel over any colour.
+
+//Enables the indexed frame for the current effect (clears it), or goes back to the LED array
+void SetLEDIndexedEnabled(bool enabled);
+
+//Gets whether the current effect draws into the indexed frame
+bool GetLEDIndexedEnabled();
+
+//Gets the indexed frame (LED_NUM_LEDS palette indices, strip order)
+uint8_t *GetLEDIndexedFrame();
+
+//Gets the palette of the indexed frame (256 colours)
+CRGB *GetLEDIndexedPalette();
+
+//Sets the rotation of the palette: index i shows palette colour (i + offset)
+void SetLEDIndexedPaletteOffset(uint8_t offset);
+
+//Gets the rotation of the palette
+uint8_t GetLEDIndexedPaletteOffset();
+
+//Rotates the palette by a number of entries
+void RotateLEDIndexedPalette(int steps);
+
+//Expands the indexed frame through the rotated palette into a LED array
+void ExpandLEDIndexedFrame(CRGB *target);
+
+#endif
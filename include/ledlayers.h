@@ -0,0 +1,61 @@
+#ifndef ledlayers_h
+#define ledlayers_h
+
+#include <Arduino.h>
+#include <FastLED.h>
+#include <ledconfig.h>
+
+//Overlay layers drawn over the base effect, bottom to top
+enum LedLayerId
+{
+    LED_LAYER_SPRITES,          //moving sprites
+    LED_LAYER_OVERLAY,          //general purpose overlay (/api/overlay)
+    LED_LAYER_CLOCK,            //time display
+    LED_LAYER_STATUS,           //device status indicators
+    LED_LAYER_COUNT
+};
+
+//How a layer is combined with what is under it
+enum LedBlendMode
+{
+    LED_BLEND_NORMAL,           //alpha over
+    LED_BLEND_ADD,              //saturating add
+    LED_BLEND_MULTIPLY,         //darkens
+    LED_BLEND_SCREEN            //lightens
+};
+
+//Clears a layer to fully transparent
+void ClearLEDLayer(int layer);
+
+//Sets a layer pixel in matrix coordinates, alpha 0 is transparent
+void SetLEDLayerPixel(int layer, int x, int y, CRGB color, uint8_t alpha=255);
+
+//Fills a rectangle of a layer in matrix coordinates (clipped)
+void FillLEDLayerRect(int layer, int x, int y, int width, int height, CRGB color, uint8_t alpha=255);
+
+//Sets how a layer is blended and its overall opacity
+void SetLEDLayerBlend(int layer, LedBlendMode mode, uint8_t opacity=255);
+
+//Shows or hides a layer without clearing it
+void SetLEDLayerVisible(int layer, bool visible);
+
+//Gets whether a layer holds anything visible
+bool IsLEDLayerVisible(int layer);
+
+//Gets whether any layer holds anything visible
+bool AnyLEDLayerVisible();
+
+//Gets whether a layer changed since the last composite
+bool GetLEDLayersChanged();
+
+//Composites the visible layers over the base frame, returns the frame to show
+//  (the base itself when there is nothing to draw over it)
+const CRGB *CompositeLEDLayers(const CRGB *base);
+
+//Gets the blend mode matching a name (normal, add, multiply, screen), normal if unknown
+LedBlendMode ParseLEDBlendMode(String name);
+
+//Gets the layer states as JSON
+String SerializeLEDLayers();
+
+#endif
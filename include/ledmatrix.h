@@ -0,0 +1,19 @@
+#ifndef ledmatrix_h
+#define ledmatrix_h
+
+#include <stdint.h>
+#include <ledconfig.h>
+
+//Gets the strip index of a matrix pixel, (0,0) being the top left corner
+//  interlaced matrices run the even rows right to left and the odd rows left to right
+static inline uint16_t LEDMatrixXY(int x, int y)
+{
+    #if LED_MATRIX_INTERLACED
+        if (y % 2 == 0)
+            x = LED_MATRIX_WIDTH - 1 - x;
+    #endif
+
+    return y * LED_MATRIX_WIDTH + x;
+}
+
+#endif
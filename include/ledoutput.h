@@ -0,0 +1,89 @@
+#ifndef ledoutput_h
+#define ledoutput_h
+
+#include <Arduino.h>
+#include <FastLED.h>
+
+//Use the following definitions:
+//Default gamma applied to every channel (1.0 to disable)
+//      #define LED_OUTPUT_GAMMA        2.2f
+//
+//Default white balance correction as 0xRRGGBB (0xFFFFFF to disable)
+//      #define LED_OUTPUT_CORRECTION   0xFFB0F0
+//
+//Default current limit of the strip in mA (0 for unlimited)
+//      #define LED_POWER_LIMIT_MA      0
+//
+//Brightness steps recovered per frame once under the limit again
+//      #define LED_POWER_RAMP_STEP     4
+//
+
+#ifndef LED_OUTPUT_GAMMA
+#define LED_OUTPUT_GAMMA        2.2f
+#endif
+
+#ifndef LED_OUTPUT_CORRECTION
+#define LED_OUTPUT_CORRECTION   0xFFB0F0
+#endif
+
+#ifndef LED_POWER_LIMIT_MA
+#define LED_POWER_LIMIT_MA      0
+#endif
+
+#ifndef LED_POWER_RAMP_STEP
+#define LED_POWER_RAMP_STEP     4
+#endif
+
+//Initializes the output buffer and registers it with FastLED
+void InitLEDOutput();
+
+//Converts a frame through the output LUT and pushes it to the strip
+void ShowLEDOutput(const CRGB *frame);
+
+//Converts the LEDs of a frame in [first, first+count) through the output LUT and pushes it to the strip,
+//  the other LEDs must be unchanged since the last call with the same frame
+void ShowLEDOutputRange(const CRGB *frame, int first, int count);
+
+//Converts an indexed frame through its palette (rotated by offset) and the output LUT and pushes it to the strip
+void ShowLEDOutputIndexed(const uint8_t *indices, const CRGB *palette, uint8_t offset);
+
+//Sets the global brightness folded into the LUT (0-255)
+void SetLEDOutputBrightness(uint8_t brightness);
+
+//Gets the global brightness folded into the LUT (0-255)
+uint8_t GetLEDOutputBrightness();
+
+//Gets the brightness actually applied after power limiting (0-255)
+uint8_t GetLEDOutputLimitedBrightness();
+
+//Sets the gamma folded into the LUT
+void SetLEDOutputGamma(float gamma);
+
+//Gets the gamma folded into the LUT
+float GetLEDOutputGamma();
+
+//Sets the white balance correction folded into the LUT (0xRRGGBB)
+void SetLEDOutputCorrection(uint32_t correction);
+
+//Gets the white balance correction folded into the LUT (0xRRGGBB)
+uint32_t GetLEDOutputCorrection();
+
+//Sets the current limit of the strip in mA (0 = unlimited)
+void SetLEDPowerLimit(unsigned long limit_ma);
+
+//Gets the current limit of the strip in mA (0 = unlimited)
+unsigned long GetLEDPowerLimit();
+
+//Gets the estimated current drawn by the last frame shown in mA
+unsigned long GetLEDPowerEstimate();
+
+//Gets whether the output settings changed since the last frame shown (LUT, power limit ramp)
+bool GetLEDOutputPending();
+
+//Gets how many frames were pushed to the strip
+unsigned long GetLEDOutputShowCount();
+
+//Gets how many frames were not pushed, the strip already showing them
+unsigned long GetLEDOutputSkipCount();
+
+#endif
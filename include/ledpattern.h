@@ -0,0 +1,36 @@
+#ifndef ledpattern_h
+#define ledpattern_h
+
+#include <stddef.h>
+#include <stdint.h>
+
+//Use the following definitions:
+//Maximum number of distinct colours in a pattern
+//      #define LED_PATTERN_MAX_COLORS  16
+//
+//Maximum number of pixels in a pattern (repeated along the strip)
+//      #define LED_PATTERN_MAX_LENGTH  64
+//
+
+#ifndef LED_PATTERN_MAX_COLORS
+#define LED_PATTERN_MAX_COLORS  16
+#endif
+
+#ifndef LED_PATTERN_MAX_LENGTH
+#define LED_PATTERN_MAX_LENGTH  64
+#endif
+
+//Compiled pattern: a small palette plus one palette index per pattern pixel
+struct LedPattern
+{
+    uint8_t     paletteSize;                        //number of distinct colours
+    uint8_t     length;                             //number of pixels in the pattern
+    uint32_t    palette[LED_PATTERN_MAX_COLORS];    //0xRRGGBB colours
+    uint8_t     indexes[LED_PATTERN_MAX_LENGTH];    //palette index of each pixel
+};
+
+//Compiles RRGGBB hexadecimal text into a pattern, returns false if invalid or too large
+//  errorPos receives the offset of the offending character
+bool CompileLEDPattern(const char *hex, size_t hexLength, LedPattern &pattern, int *errorPos=NULL);
+
+#endif
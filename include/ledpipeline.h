@@ -0,0 +1,56 @@
+#ifndef ledpipeline_h
+#define ledpipeline_h
+
+#include <Arduino.h>
+#include <FastLED.h>
+#include <ledconfig.h>
+
+//Use the following definitions:
+//Push frames to the strip on their own task, overlapping the next frame (0 to push inline)
+//      #define LED_PIPELINE_ENABLED    1
+//
+//Core and priority of the output task (loop() runs on core 1 at priority 1)
+//      #define LED_PIPELINE_CORE       1
+//      #define LED_PIPELINE_PRIORITY   2
+//
+
+#ifndef LED_PIPELINE_ENABLED
+#define LED_PIPELINE_ENABLED    1
+#endif
+
+#ifndef LED_PIPELINE_CORE
+#define LED_PIPELINE_CORE       1
+#endif
+
+#ifndef LED_PIPELINE_PRIORITY
+#define LED_PIPELINE_PRIORITY   2
+#endif
+
+//Pushes a buffer to the strip, called on the output task (e.g. FastLED.show(), a simulated delay on the host)
+typedef void (*LedPipelineDriver)(const CRGB *buffer, int count);
+
+//Starts the output task handing frames to the driver
+void InitLEDPipeline(LedPipelineDriver driver);
+
+//Gets the buffer the next frame is written into, never read by the driver
+CRGB *GetLEDPipelineBackBuffer();
+
+//Gets the buffer of the last frame handed to the driver (read only)
+const CRGB *GetLEDPipelineFrontBuffer();
+
+//Waits until the driver is done with the last frame handed to it
+void WaitLEDPipeline();
+
+//Hands the back buffer to the driver and swaps the buffers, waits for the previous frame first
+void SubmitLEDPipelineFrame();
+
+//Gets how many frames were handed to the driver
+unsigned long GetLEDPipelineFrames();
+
+//Gets the total time spent waiting for the driver in us
+unsigned long GetLEDPipelineWaitTime();
+
+//Gets how long the driver took for the last frame in us
+unsigned long GetLEDPipelineDriverTime();
+
+#endif
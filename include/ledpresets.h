@@ -0,0 +1,39 @@
+#ifndef ledpresets_h
+#define ledpresets_h
+
+#include <stddef.h>
+#include <stdint.h>
+#include <ledpattern.h>
+
+//Kind of effect a preset activates
+enum LedPresetType
+{
+    LED_PRESET_PATTERN = 0,     //repeating pattern, uses the whole compiled pattern
+    LED_PRESET_SOLID,           //solid colour, uses the first palette colour
+    LED_PRESET_BEAT,            //beat, uses the first palette colour
+    LED_PRESET_RAINBOW          //rainbow, pattern unused
+};
+
+//Built-in effect preset, decoded at compile time and stored in flash
+struct LedPreset
+{
+    const char      *name;          //name used by /api/effect
+    LedPresetType   type;           //effect to activate
+    LedPattern      pattern;        //decoded colours
+    float           speed;          //travel speed in m/s, 0 to keep current
+    int             brightness;     //0-255, -1 to keep current
+};
+
+//Gets the number of built-in presets
+int GetLEDPresetCount();
+
+//Gets a built-in preset by index, NULL if out of range
+const LedPreset *GetLEDPreset(int index);
+
+//Finds a built-in preset by name, NULL if not found
+const LedPreset *FindLEDPreset(const char *name);
+
+//Gets the name of a preset type as used by /api/presets
+const char *GetLEDPresetTypeName(LedPresetType type);
+
+#endif
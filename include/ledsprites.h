@@ -0,0 +1,78 @@
+#ifndef ledsprites_h
+#define ledsprites_h
+
+#include <Arduino.h>
+#include <FastLED.h>
+
+//Use the following definitions:
+//Number of distinct sprite images kept in memory
+//      #define LED_SPRITE_IMAGES       8
+//
+//Largest sprite image in pixels, after cropping its transparent borders
+//      #define LED_SPRITE_MAX_PIXELS   256
+//
+//Number of sprites on screen
+//      #define LED_SPRITE_MAX          32
+//
+
+#ifndef LED_SPRITE_IMAGES
+#define LED_SPRITE_IMAGES       8
+#endif
+
+#ifndef LED_SPRITE_MAX_PIXELS
+#define LED_SPRITE_MAX_PIXELS   256
+#endif
+
+#ifndef LED_SPRITE_MAX
+#define LED_SPRITE_MAX          32
+#endif
+
+//What a moving sprite does at the edge of the matrix
+enum LedSpriteEdge
+{
+    LED_SPRITE_WRAP,            //leaves on one side, comes back on the other
+    LED_SPRITE_BOUNCE,          //reverses its velocity
+    LED_SPRITE_STOP             //stays at the edge
+};
+
+//Gets the sprite image loaded under a name, -1 if not loaded
+int FindLEDSpriteImage(const char *name);
+
+//Loads a sprite image (image store format), cropping the borders of the transparent key colour
+//  returns the image slot, or -1 if invalid, too large or no slot is free
+int LoadLEDSpriteImage(const char *name, const String &data, CRGB key=CRGB::Black);
+
+//Places a new sprite, higher z is drawn on top, returns the sprite id or -1 if full
+int AddLEDSprite(int image, int x, int y, int z=0);
+
+//Removes a sprite
+void RemoveLEDSprite(int sprite);
+
+//Removes all sprites and unloads their images
+void ClearLEDSprites();
+
+//Moves a sprite (top left corner of its cropped image)
+void MoveLEDSprite(int sprite, int x, int y);
+
+//Sets the velocity of a sprite in pixels per second
+void SetLEDSpriteVelocity(int sprite, float vx, float vy);
+
+//Sets what a sprite does at the edge of the matrix
+void SetLEDSpriteEdge(int sprite, LedSpriteEdge edge);
+
+//Sets the drawing order of a sprite, higher is on top
+void SetLEDSpriteZ(int sprite, int z);
+
+//Shows or hides a sprite
+void SetLEDSpriteVisible(int sprite, bool visible);
+
+//Moves the sprites and redraws the sprite layer if anything visible changed - to be called every frame
+void UpdateLEDSprites(unsigned long now);
+
+//Gets the edge behaviour matching a name (wrap, bounce, stop), wrap if unknown
+LedSpriteEdge ParseLEDSpriteEdge(String name);
+
+//Gets the sprites and loaded images as JSON
+String SerializeLEDSprites();
+
+#endif
@@ -0,0 +1,23 @@
+#ifndef lifeutils_h
+#define lifeutils_h
+
+#include <stdint.h>
+
+//Plain C++ (no Arduino dependency) so it can be compiled and benchmarked on the host.
+
+//Rows are packed one bit per cell, bit 0 being the leftmost column
+#define LIFE_MAX_WIDTH          32
+
+//Computes the next generation of a wrap-around grid, 32 cells at a time
+void LifeStep(const uint32_t *rows, uint32_t *next, int width, int height);
+
+//Fills a grid with random cells, densityPercent of them alive
+void LifeSeed(uint32_t *rows, int width, int height, uint32_t &rng, int densityPercent);
+
+//Gets a hash of a grid, to detect still lifes and short oscillators
+uint32_t LifeHash(const uint32_t *rows, int height);
+
+//Gets the number of live cells of a grid
+int LifePopulation(const uint32_t *rows, int height);
+
+#endif
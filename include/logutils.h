@@ -0,0 +1,98 @@
+#ifndef logutils_h
+#define logutils_h
+
+#include <Arduino.h>
+
+//Log levels
+#define LOG_LEVEL_NONE          0
+#define LOG_LEVEL_ERROR         1
+#define LOG_LEVEL_WARN          2
+#define LOG_LEVEL_INFO          3
+#define LOG_LEVEL_DEBUG         4
+
+//Use the following definitions:
+//Highest level compiled in - calls above it are removed by the preprocessor
+//      #define LOG_LEVEL               LOG_LEVEL_DEBUG
+//
+//Number of pending messages the ring buffer can hold (power of 2)
+//      #define LOG_QUEUE_SIZE          32
+//
+//Maximum length of a single message, longer ones are truncated
+//      #define LOG_LINE_LENGTH         96
+//
+//Number of lines kept for the HTTP tail endpoint
+//      #define LOG_TAIL_LINES          32
+//
+//Messages per second allowed at each level, and burst allowed above that rate (0 for no limit)
+//      #define LOG_RATE_PER_SECOND     10
+//      #define LOG_RATE_BURST          20
+//
+
+#ifndef LOG_LEVEL
+#define LOG_LEVEL               LOG_LEVEL_DEBUG
+#endif
+
+#ifndef LOG_QUEUE_SIZE
+#define LOG_QUEUE_SIZE          32
+#endif
+
+#ifndef LOG_LINE_LENGTH
+#define LOG_LINE_LENGTH         96
+#endif
+
+#ifndef LOG_TAIL_LINES
+#define LOG_TAIL_LINES          32
+#endif
+
+#ifndef LOG_RATE_PER_SECOND
+#define LOG_RATE_PER_SECOND     10
+#endif
+
+#ifndef LOG_RATE_BURST
+#define LOG_RATE_BURST          20
+#endif
+
+//Logging macros, printf style
+#if LOG_LEVEL >= LOG_LEVEL_ERROR
+    #define LOG_ERROR(...)      LogPrintf(LOG_LEVEL_ERROR, __VA_ARGS__)
+#else
+    #define LOG_ERROR(...)
+#endif
+
+#if LOG_LEVEL >= LOG_LEVEL_WARN
+    #define LOG_WARN(...)       LogPrintf(LOG_LEVEL_WARN, __VA_ARGS__)
+#else
+    #define LOG_WARN(...)
+#endif
+
+#if LOG_LEVEL >= LOG_LEVEL_INFO
+    #define LOG_INFO(...)       LogPrintf(LOG_LEVEL_INFO, __VA_ARGS__)
+#else
+    #define LOG_INFO(...)
+#endif
+
+#if LOG_LEVEL >= LOG_LEVEL_DEBUG
+    #define LOG_DEBUG(...)      LogPrintf(LOG_LEVEL_DEBUG, __VA_ARGS__)
+#else
+    #define LOG_DEBUG(...)
+#endif
+
+//Starts the background task draining the log to the serial port
+void InitLog();
+
+//Formats a line into the log queue, never blocks (drops the line when full or over the rate of its level)
+bool LogPrintf(int level, const char *format, ...) __attribute__((format(printf, 2, 3)));
+
+//Queues raw text for the serial port, optionally terminating the line
+bool LogWrite(const char *text, bool newline);
+
+//Gets the number of messages dropped because the queue was full
+unsigned long GetLogDroppedCount();
+
+//Gets the number of messages dropped because their level was over its rate
+unsigned long GetLogThrottledCount();
+
+//Gets the last lines written to the log, oldest first
+String GetLogTail(int lines=LOG_TAIL_LINES);
+
+#endif
@@ -0,0 +1,55 @@
+#ifndef loopmonitor_h
+#define loopmonitor_h
+
+#include <Arduino.h>
+
+//Use the following definitions:
+//Default time budget for a single loop phase, in milliseconds
+//      #define LOOP_MONITOR_DEFAULT_BUDGET_MS  50
+//
+//Number of over-budget records kept (most recent first)
+//      #define LOOP_MONITOR_OFFENDERS          8
+//
+
+#ifndef LOOP_MONITOR_DEFAULT_BUDGET_MS
+#define LOOP_MONITOR_DEFAULT_BUDGET_MS  50
+#endif
+
+#ifndef LOOP_MONITOR_OFFENDERS
+#define LOOP_MONITOR_OFFENDERS          8
+#endif
+
+//Histogram buckets: <1ms, <2ms, <4ms ... <1024ms, >=1024ms
+#define LOOP_MONITOR_BUCKETS            12
+
+//Phases of the main loop
+enum LoopPhase
+{
+    LOOP_PHASE_CLIENT = 0,      //web requests
+    LOOP_PHASE_SHOWCASE,        //showcase image rotation
+    LOOP_PHASE_DRAW,            //LED effect frame
+    LOOP_PHASE_COUNT
+};
+
+//Marks the start of a loop phase
+void LoopPhaseBegin(LoopPhase phase);
+
+//Marks the end of a loop phase, returns true if the phase exceeded the budget
+bool LoopPhaseEnd(LoopPhase phase);
+
+//Attaches the route being served to the most recent offender record
+void SetLoopOffenderRoute(String route);
+
+//Sets the time budget of a single loop phase in milliseconds
+void SetLoopMonitorBudget(unsigned long budget_ms);
+
+//Gets the time budget of a single loop phase in milliseconds
+unsigned long GetLoopMonitorBudget();
+
+//Clears histograms and offender records
+void ResetLoopMonitor();
+
+//Gets the phase statistics and offender records as JSON
+String SerializeLoopMonitor();
+
+#endif
@@ -0,0 +1,42 @@
+#ifndef parallelutils_h
+#define parallelutils_h
+
+//Use the following definitions:
+//Split row jobs with a helper task on the other core (0 to run them inline)
+//      #define PARALLEL_ENABLED        1
+//
+//Core and priority of the helper task (loop() runs on core 1 at priority 1)
+//      #define PARALLEL_CORE           0
+//      #define PARALLEL_PRIORITY       1
+//
+//Jobs with fewer rows run inline, splitting them costs more than it saves
+//      #define PARALLEL_MIN_ROWS       4
+//
+
+#ifndef PARALLEL_ENABLED
+#define PARALLEL_ENABLED        1
+#endif
+
+#ifndef PARALLEL_CORE
+#define PARALLEL_CORE           0
+#endif
+
+#ifndef PARALLEL_PRIORITY
+#define PARALLEL_PRIORITY       1
+#endif
+
+#ifndef PARALLEL_MIN_ROWS
+#define PARALLEL_MIN_ROWS       4
+#endif
+
+//Row job: processes rows [first, last), must only write its own rows (runs on either core)
+typedef void (*ParallelRowsJob)(int first, int last, void *context);
+
+//Starts the helper task
+void InitParallel();
+
+//Runs a job over rows [0, rows): the helper task takes the first half, the caller the second,
+//  returns once both are done - loop task only, not from inside a job
+void ParallelForRows(int rows, ParallelRowsJob job, void *context);
+
+#endif
@@ -0,0 +1,68 @@
+#ifndef traceutils_h
+#define traceutils_h
+
+#include <Arduino.h>
+
+//comment next line to compile tracing out entirely (macros become no-ops)
+#define TRACEUTILS_ENABLED 1
+
+//Use the following definitions:
+//Number of events kept in the trace ring buffer (16 bytes each)
+//      #define TRACE_BUFFER_SIZE       256
+//
+//Is recording active at boot? - can be changed at runtime with SetTraceEnabled()
+//      #define TRACE_DEFAULT_ENABLED   false
+//
+
+#ifndef TRACE_BUFFER_SIZE
+#define TRACE_BUFFER_SIZE       256
+#endif
+
+#ifndef TRACE_DEFAULT_ENABLED
+#define TRACE_DEFAULT_ENABLED   false
+#endif
+
+//Tracing macros - names must be string literals (only the pointer is stored)
+#ifdef TRACEUTILS_ENABLED
+    #define TRACE_CONCAT_INNER(a, b)    a##b
+    #define TRACE_CONCAT(a, b)          TRACE_CONCAT_INNER(a, b)
+    #define TRACE_BEGIN(name)           TraceRecord(name, 'B')
+    #define TRACE_END(name)             TraceRecord(name, 'E')
+    #define TRACE_SCOPE(name)           TraceScope TRACE_CONCAT(_traceScope, __LINE__)(name)
+#else
+    #define TRACE_BEGIN(name)
+    #define TRACE_END(name)
+    #define TRACE_SCOPE(name)
+#endif
+
+//Records a trace event (phase 'B' for begin, 'E' for end) - loop task only
+void TraceRecord(const char *name, char phase);
+
+//Enables or disables recording at runtime
+void SetTraceEnabled(bool enabled);
+
+//Gets if recording is currently active
+bool GetTraceEnabled();
+
+//Discards all recorded events
+void ClearTrace();
+
+//Gets the number of events currently held in the buffer
+int GetTraceEventCount();
+
+//Gets the next chunk of Chrome trace-event JSON, returns false when nothing is left
+//  cursor must start at 0, recording should be paused while exporting
+bool GetTraceJsonChunk(int &cursor, String &chunk);
+
+//Records a begin event on construction and the matching end event on destruction
+class TraceScope
+{
+public:
+    TraceScope(const char *name) : _name(name) { TraceRecord(_name, 'B'); }
+    ~TraceScope() { TraceRecord(_name, 'E'); }
+
+private:
+    const char *_name;
+};
+
+#endif
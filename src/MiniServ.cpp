@@ -17,6 +17,9 @@
 #include <fileutils.h>
 #include <WebServer.h>
 #include <MiniServ.h>
+#include <traceutils.h>
+#include <logutils.h>
+#include <arduinoutils.h>
 
 //References:
 //https://github.com/espressif/arduino-esp32/blob/master/libraries/WebServer/
@@ -53,12 +56,7 @@ void MiniServ::InitWiFi(String ssid, String password, int timeout_ms, String hos
 
     int wait_time_ms = 0;
     
-    if (Serial)
-    {
-        Serial.print("Connecting to ");
-        Serial.print(_SSID);
-        Serial.print("... ");
-    }
+    PrintSerial("Connecting to " + _SSID + "... ");
 
     if (hostname!="")
         WiFi.setHostname(hostname.c_str());
@@ -67,8 +65,7 @@ void MiniServ::InitWiFi(String ssid, String password, int timeout_ms, String hos
 
     while (wait_time_ms < timeout_ms && WiFi.status() != WL_CONNECTED)
     {
-        if (Serial)
-            Serial.print(".");
+        PrintSerial(".");
 
         delay(500);
         wait_time_ms += 500;
@@ -78,8 +75,7 @@ void MiniServ::InitWiFi(String ssid, String password, int timeout_ms, String hos
     {
         _isWiFiConnected = false;
 
-        if (Serial)
-            Serial.println(" Timeout!");
+        PrintlnSerial(" Timeout!");
     }
     else
     {
@@ -90,31 +86,18 @@ void MiniServ::InitWiFi(String ssid, String password, int timeout_ms, String hos
             WiFi.onEvent(OnLostConnection, WiFiEvent_t::ARDUINO_EVENT_WIFI_STA_DISCONNECTED);
         }
 
-        if (Serial)
-        {
-            Serial.print(hostname);
-            Serial.println(" Connected!");
-
-            Serial.print("signal strength (RSSI): ");
-            Serial.print(WiFi.RSSI());
-            Serial.println(" dBm");
-
-            Serial.print("IP address: ");
-            Serial.println(WiFi.localIP());
-        }
+        PrintlnSerial(hostname + " Connected!");
+        LOG_INFO("signal strength (RSSI): %d dBm", WiFi.RSSI());
+        LOG_INFO("IP address: %s", WiFi.localIP().toString().c_str());
     }
 }
 
 //Handles lost connections
 void OnLostConnection(WiFiEvent_t event, WiFiEventInfo_t info)
 {
-    if (Serial)
-    {
-        Serial.println("Disconnected from WiFi access point");
-        Serial.print("WiFi lost connection. Reason: ");
-        Serial.println(info.wifi_sta_disconnected.reason);
-        Serial.println("Trying to Reconnect...");
-    }
+    LOG_WARN("Disconnected from WiFi access point");
+    LOG_WARN("WiFi lost connection. Reason: %d", info.wifi_sta_disconnected.reason);
+    LOG_INFO("Trying to Reconnect...");
 
     //avoid endless loops during reconnection process
     WiFi.removeEvent(WiFiEvent_t::ARDUINO_EVENT_WIFI_STA_DISCONNECTED);
@@ -126,8 +109,7 @@ void OnLostConnection(WiFiEvent_t event, WiFiEventInfo_t info)
     
     while (wait_time_ms < 60000 && WiFi.status() != WL_CONNECTED)
     {
-        if (Serial)
-            Serial.print(".");
+        PrintSerial(".");
 
         delay(500);
         wait_time_ms += 500;
@@ -135,20 +117,15 @@ void OnLostConnection(WiFiEvent_t event, WiFiEventInfo_t info)
 
     if (WiFi.status() != WL_CONNECTED)
     {
-        if (Serial)
-            Serial.println(" Timeout!");
+        PrintlnSerial(" Timeout!");
     }
     else
     {
         //re-attach event
         WiFi.onEvent(OnLostConnection, WiFiEvent_t::ARDUINO_EVENT_WIFI_STA_DISCONNECTED);
 
-        if (Serial)
-        {
-            Serial.println("Re-connected!");
-            Serial.print("IP address: ");
-            Serial.println(WiFi.localIP());
-        }
+        PrintlnSerial("Re-connected!");
+        LOG_INFO("IP address: %s", WiFi.localIP().toString().c_str());
     }
     
 }
@@ -161,12 +138,8 @@ void MiniServ::InitAP(String ssid, String password)
 
     _isAPConnected = WiFi.softAP(_SSID, _password);
 
-    if (Serial)
-    {
-        Serial.println("Access Point Started!");
-        Serial.print("Ip Address:");
-        Serial.println(WiFi.softAPIP());
-    }
+    LOG_INFO("Access Point Started!");
+    LOG_INFO("Ip Address:%s", WiFi.softAPIP().toString().c_str());
 }
 
 //checks if the WiFi connection is established
@@ -191,27 +164,28 @@ void MiniServ::InitWebServer(int port, int client_timeout)
 
         WServer.begin(_port);
 
-        if (Serial)
-        {
-            Serial.print("Webserver ready on port ");
-            Serial.print(_port);
-            Serial.println("!");
-        }
+        LOG_INFO("Webserver ready on port %d!", _port);
     }
     else
     {
-        if(Serial)
-            Serial.println("Cannot instantiate WebServer, no WiFi available.");
+        LOG_ERROR("Cannot instantiate WebServer, no WiFi available.");
     }
 }
 
-//Checks if there is an inbound client request
-void MiniServ::HandleClientRequests()
+//Checks if there is an inbound client request, returns true if one was handled (responded to or uploaded)
+bool MiniServ::HandleClientRequests()
 {
+    //the request path stays the one of the last request: tell whether this call served one
+    _requestHandled = false;
+
+    TRACE_BEGIN("WebServer.handleClient");
     WServer.handleClient();
+    TRACE_END("WebServer.handleClient");
 
     //allow the cpu to switch to other tasks
     delay(2);
+
+    return _requestHandled;
 }
 
 //Gets the raw RequestHeaders
@@ -248,12 +222,14 @@ String MiniServ::GetRequestPath()
 //Sends an HTML response to the Web Client
 void MiniServ::SendResponse(String htmlBody)
 {
+    _requestHandled = true;
     WServer.send(200, "text/html", htmlBody);
 }
 
 //Sends an HTML response to the Web Client, with specific response code and content type
 void MiniServ::SendResponse(String htmlBody, int responseCode, String contentType)
 {
+    _requestHandled = true;
     WServer.send(responseCode, contentType, htmlBody);
 }
 
@@ -267,12 +243,37 @@ void MiniServ::SendFileResponse(const char *filePath)
 //sends a file to the Web Client, with specific response code and content type
 void MiniServ::SendFileResponse(const char *filePath, int responseCode, String contentType)
 {
+    _requestHandled = true;
     WServer.send(responseCode, contentType, FSReadFile(filePath));
 }
 
+//Starts a chunked response of unknown length to the Web Client
+void MiniServ::BeginChunkedResponse(int responseCode, String contentType)
+{
+    _requestHandled = true;
+    WServer.setContentLength(CONTENT_LENGTH_UNKNOWN);
+    WServer.send(responseCode, contentType, "");
+}
+
+//Sends the next chunk of a chunked response
+void MiniServ::SendResponseChunk(String chunk)
+{
+    //an empty chunk would terminate the response
+    if (chunk.length() > 0)
+        WServer.sendContent(chunk);
+}
+
+//Terminates a chunked response
+void MiniServ::EndChunkedResponse()
+{
+    WServer.sendContent("");
+}
+
 //Sends a 404 Not Found to the Web Client, optionally with a body
 void MiniServ::SendNotFound(String htmlBody)
 {
+    _requestHandled = true;
+
     //Write string
     WServer.send(404, "text/html", htmlBody);
 }
@@ -286,11 +287,10 @@ void MiniServ::SendBinaryFileResponse(const char *filePath)
 //Sends a binary file to the Web Client
 void MiniServ::SendBinaryFileResponse(const char *filePath, int responseCode, String contentType)
 {
+    _requestHandled = true;
+
     if(!SPIFFS.begin(true)){
-        #ifdef MINISERV_DEBUGMODE
-            if (Serial)
-                Serial.println("An Error has occurred while mounting SPIFFS");
-        #endif        
+        LOG_ERROR("An Error has occurred while mounting SPIFFS");
     }
     else
     {    
@@ -298,13 +298,7 @@ void MiniServ::SendBinaryFileResponse(const char *filePath, int responseCode, St
         File file = SPIFFS.open(filePath);
 
         if(!file){
-            #ifdef MINISERV_DEBUGMODE
-                if (Serial)
-                {
-                    Serial.print("Unable to to open file "); 
-                    Serial.println(filePath);
-                }
-            #endif    
+            LOG_DEBUG("Unable to to open file %s", filePath);
         }
         else
         {
@@ -317,13 +311,7 @@ void MiniServ::SendBinaryFileResponse(const char *filePath, int responseCode, St
             //close file
             file.close();
 
-            #ifdef MINISERV_DEBUGMODE
-                if (Serial)
-                {
-                    Serial.print("File read: ");
-                    Serial.println(filePath);
-                }
-            #endif                
+            LOG_DEBUG("File read: %s", filePath);
         }
     }
 }
@@ -344,6 +332,8 @@ String MiniServ::GetQueryStringParameter(int paramIndex)
 //Sends a 404 Not Found to the Web Client and the content of a file in body.
 void MiniServ::SendFileNotFound(const char *filePath)
 {
+    _requestHandled = true;
+
     //Write body
     WServer.send(404, "text/html", FSReadFile(filePath));
 }
@@ -373,6 +363,8 @@ void MiniServ::SaveFileUpload()
 //Saves an uploaded file to the file system
 void MiniServ::SaveFileUploadAs(String filePath)
 {
+  _requestHandled = true;
+
   HTTPUpload& upload = WServer.upload();
 
   String fileName = "";
@@ -390,10 +382,7 @@ void MiniServ::SaveFileUploadAs(String filePath)
     //Start of the upload process
     if(!SPIFFS.begin(true))
     {
-        #ifdef MINISERV_DEBUGMODE
-            if (Serial)
-                Serial.println("An Error has occurred while mounting SPIFFS");
-        #endif        
+        LOG_ERROR("An Error has occurred while mounting SPIFFS");
     }
     else
     {
@@ -402,24 +391,12 @@ void MiniServ::SaveFileUploadAs(String filePath)
         {
             SPIFFS.remove(fileName);
 
-            #ifdef MINISERV_DEBUGMODE
-                if (Serial)
-                {
-                    Serial.print("Deleted file: ");
-                    Serial.println(fileName);
-                }
-            #endif
+            LOG_DEBUG("Deleted file: %s", fileName.c_str());
         }
 
         //create file
         uploadFile = SPIFFS.open(fileName, FILE_WRITE);
-        #ifdef MINISERV_DEBUGMODE
-            if (Serial)
-            {
-                Serial.print("Created file: ");
-                Serial.println(fileName);
-            }
-        #endif        
+        LOG_DEBUG("Created file: %s", fileName.c_str());
     }
     
   } else if (upload.status == UPLOAD_FILE_WRITE) {
@@ -427,14 +404,7 @@ void MiniServ::SaveFileUploadAs(String filePath)
     {
         uploadFile.write(upload.buf, upload.currentSize);
 
-        #ifdef MINISERV_DEBUGMODE
-            if (Serial)
-            {
-                Serial.print("Wrote ");
-                Serial.print(upload.currentSize);
-                Serial.println("bytes to file.");                
-            }
-        #endif
+        LOG_DEBUG("Wrote %u bytes to file.", (unsigned int) upload.currentSize);
     }
 
   } else if (upload.status == UPLOAD_FILE_END) {
@@ -442,14 +412,7 @@ void MiniServ::SaveFileUploadAs(String filePath)
     {
         uploadFile.close();
 
-        if (Serial)
-        {
-            Serial.print("Upload complete!");
-            Serial.print(fileName);
-            Serial.print(", ");
-            Serial.print(upload.totalSize);
-            Serial.println("bytes.");                
-        }
+        LOG_INFO("Upload complete!%s, %u bytes.", fileName.c_str(), (unsigned int) upload.totalSize);
     }
   }    
 }
@@ -1,29 +1,90 @@
-
 #include <NtpHelper.h>
 #include <time.h>
 #include <Arduino.h>
 
+//any earlier system time means SNTP has not answered yet
+#define NTP_MIN_VALID_EPOCH     1577836800L     //2020-01-01
+
 //Constructor
 NtpHelper::NtpHelper()
 {
-  
+    _baseEpoch = 0;
+    _baseMillis = 0;
+    _baseSecondsOfDay = 0;
 }
 
-void NtpHelper::ConfigNTP(String NTPserver1, String NTPserver2, String NTPserver3)
+void NtpHelper::ConfigNTP(String NTPserver1, String NTPserver2, String NTPserver3, String timezone)
 {
+    _servers[0] = NTPserver1;
+    _servers[1] = NTPserver2;
+    _servers[2] = NTPserver3;
+    _timezone = timezone;
 
-    configTime(-5 * 3600, 3600, "time.nrc.ca", "time1.google.com", "pool.ntp.org");
-  
+    configTzTime(_timezone.c_str(), _servers[0].c_str(), _servers[1].c_str(), _servers[2].c_str());
+
+    //force a new anchor once the time comes in
+    _baseEpoch = 0;
 }
 
-String GetFormattedTime(const char *format)
+//Takes a new reference point from the system clock, returns false if the time is not set yet
+bool NtpHelper::Anchor()
 {
-    struct tm theTime;
-    if (getLocalTime(&theTime))
+    time_t now = time(NULL);
+
+    if (now < NTP_MIN_VALID_EPOCH)
+        return false;
+
+    struct tm local;
+    localtime_r(&now, &local);
+
+    _baseEpoch = now;
+    _baseMillis = millis();
+    _baseSecondsOfDay = local.tm_hour * 3600L + local.tm_min * 60L + local.tm_sec;
+
+    return true;
+}
+
+bool NtpHelper::IsTimeSet()
+{
+    return Now() != 0;
+}
+
+//Gets the current epoch from the cached time base, 0 if the time is not set yet
+time_t NtpHelper::Now()
+{
+    //re-anchor from time to time to follow SNTP corrections and DST changes
+    if (_baseEpoch == 0 || millis() - _baseMillis >= NTP_RESYNC_MS)
+        if (!Anchor())
+            return 0;
+
+    return _baseEpoch + (millis() - _baseMillis) / 1000;
+}
+
+//Gets the local time of day from the cached time base, without allocation
+bool NtpHelper::GetLocalClock(int &hours, int &minutes, int &seconds)
+{
+    if (Now() == 0)
+        return false;
+
+    long secondsOfDay = (_baseSecondsOfDay + (long) ((millis() - _baseMillis) / 1000)) % 86400L;
+
+    hours = secondsOfDay / 3600;
+    minutes = (secondsOfDay / 60) % 60;
+    seconds = secondsOfDay % 60;
+
+    return true;
+}
+
+String GetFormattedTime(time_t now, const char *format)
+{
+    if (now != 0)
     {
+        struct tm theTime;
+        localtime_r(&now, &theTime);
+
         char timeoutput[128];
         strftime(timeoutput, 128, format, &theTime);
-        
+
         return timeoutput;
     }
     else
@@ -32,15 +93,20 @@ String GetFormattedTime(const char *format)
 
 String NtpHelper::GetTime()
 {
-    return GetFormattedTime("%H:%M:%S");
+    return GetFormattedTime(Now(), "%H:%M:%S");
 }
 
 String NtpHelper::GetDateTime()
 {
-    return GetFormattedTime("%Y-%m-%d %H:%M:%S");
+    return GetFormattedTime(Now(), "%Y-%m-%d %H:%M:%S");
 }
 
 String NtpHelper::GetDate()
 {
-    return GetFormattedTime("%Y-%m-%d");
-}
\ No newline at end of file
+    return GetFormattedTime(Now(), "%Y-%m-%d");
+}
+
+String NtpHelper::GetTimeFormat(String format)
+{
+    return GetFormattedTime(Now(), format.c_str());
+}
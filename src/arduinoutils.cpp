@@ -12,6 +12,7 @@
 //
 //---------------------------------------------------------------------------
 #include <Arduino.h>
+#include <logutils.h>
 
 #ifndef BOARD_PIN_LED
 #define BOARD_PIN_LED 2
@@ -56,20 +57,21 @@ void InitSerial()
 {
     if (!Serial)
         Serial.begin(BOARD_COM_SPEED);
+
+    //serial output goes through the asynchronous log from now on
+    InitLog();
 }
 
-//Print to serial port
+//Print to serial port (queued, never blocks)
 void PrintSerial(String text)
 {
-    if (Serial)
-        Serial.print(text);
+    LogWrite(text.c_str(), false);
 }
 
-//Print to serial port and adds new line
+//Print to serial port and adds new line (queued, never blocks)
 void PrintlnSerial(String text)
 {
-    if (Serial)
-        Serial.println(text);
+    LogWrite(text.c_str(), true);
 }
 
 //Splits a string into an array
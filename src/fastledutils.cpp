@@ -13,51 +13,88 @@
 #include <arduinoutils.h>
 #include <FastLED.h>
 #include <fastledutils.h>
-
-//uncomment to enable debug mode
-#define FASTLEDUTILS_DEBUGMODE  1
-
-#ifndef LED_MATRIX_WIDTH
-#define LED_MATRIX_WIDTH        16
-#endif
-
-#ifndef LED_MATRIX_HEIGHT
-#define LED_MATRIX_HEIGHT       16
-#endif
-
-#ifndef LED_NUM_LEDS
-#define LED_NUM_LEDS            (LED_MATRIX_WIDTH*LED_MATRIX_HEIGHT)
-#endif
-
-#ifndef LED_MATRIX_INTERLACED
-#define LED_MATRIX_INTERLACED   0
-#endif
-
-#ifndef LED_GPIO_PIN
-#define LED_GPIO_PIN            13
-#endif
-
-#ifndef LED_PX_PER_METER
-#define LED_PX_PER_METER        60
-#endif
+#include <traceutils.h>
+#include <logutils.h>
+#include <hexutils.h>
+#include <ledpattern.h>
+#include <ledconfig.h>
+#include <ledoutput.h>
+#include <ledimage.h>
+#include <ledlayers.h>
+#include <ledmatrix.h>
+#include <ledfont.h>
+#include <lifeutils.h>
+#include <fxutils.h>
+#include <ledsprites.h>
+#include <ledanim.h>
+#include <imagepack.h>
+#include <ledindexed.h>
+#include <parallelutils.h>
+#include <ledgovernor.h>
+
+//colour data is decoded straight into CRGB arrays
+static_assert(sizeof(CRGB) == 3, "CRGB must be packed as 3 bytes");
 
 //Global variables
 CRGB leds[LED_NUM_LEDS];                        //Main LED array
 long ledFramerate = 100;                        //current framerate in milliseconds
+long ledFramePeriod = 100;                      //framerate in milliseconds after the governor
 int ledFrameIndex = 0;                          //Current frame index
 int ledBrightness = 64;                         //Current LED brightness
 String ledCurrentEffect = "DEFAULT";            //currently displayed effect
 String ledCurrentEffectParameters = "";         //current effect params
 unsigned long ledCurrentTime = millis();        // Current time
 unsigned long ledPreviousTime = 0;              // Previous time
+LedPattern ledCustomPattern;                    //pattern compiled from effect parameters
+const LedPattern *ledActivePattern = NULL;      //pattern displayed by the pattern effect
+bool ledPatternScroll = false;                  //scroll pattern one pixel per frame
+int ledPatternPhase = 0;                        //pattern index shown on the first pixel
+CRGB ledBeatColor = CRGB(0, 0, 64);             //colour of the beat effect, decoded on activation
+CRGB ledImagePixels[LED_IMAGE_MAX_PIXELS];      //decoded image, in its own size
+LedImageMode ledImageMode = LED_IMAGE_NEAREST;  //how images are fitted onto the matrix
+CRGB ledTextColor = CRGB(255, 255, 255);        //colour of the scrolling text
+int ledTextColumn = 0;                          //next text column to reveal
+uint32_t ledLifeRows[2][LED_MATRIX_HEIGHT];     //life generations (current and next), bit packed
+int ledLifeCurrent = 0;                         //index of the current generation
+uint8_t ledLifeAge[LED_MATRIX_HEIGHT][LED_MATRIX_WIDTH];  //generations each cell has been alive
+uint32_t ledLifeRng = 0;                        //seed generator state
+uint32_t ledLifeHistory[LED_LIFE_HISTORY];      //hashes of the last generations
+int ledLifeStagnant = 0;                        //generations without visible progress
+int ledLifePopulation = 0;                      //live cells of the previous generation
+ImagePack ledImagePack = { NULL, 0, 0 };      //mapped image pack, empty if none
+int ledDirtyFirst = LED_NUM_LEDS;               //first LED changed since the strip was shown
+int ledDirtyLast = -1;                          //last LED changed since the strip was shown
+ImagePackEntry ledPackImage;                    //pack image displayed
+int ledPackFrame = 0;                           //pack image frame displayed
+unsigned long ledPackFrameTime = 0;             //time the pack frame was drawn
+uint8_t ledFxValues[LED_NUM_LEDS];              //fire heat or noise values, row major
+uint32_t ledFxRng = 0;                          //fire random generator state
 
 //Local Prototypes
+int DecodeLEDColors(const String &hex, CRGB *colors, int maxColors);
+void ShowLEDStrip();
+void ShowLEDStripChanges();
+void SetLEDPixel(int index, CRGB color);
+void MarkLEDRegionChanged(int first, int count);
 void DrawLEDCurrentEffectFrame();
 void DrawLEDBeatEffect();
 void DrawLEDRainbowEffect();
 void DrawLEDSolidEffect();
 void DrawLEDImageEffect();
+void DrawLEDAnimationEffect();
+void DrawLEDPackEffect();
+void DrawLEDPackFrame();
 void DrawLEDPatternEffect();
+void DrawLEDTextEffect();
+void ShiftLEDTextBand(int top);
+void DrawLEDLifeEffect();
+void SeedLEDLife();
+void DrawLEDFireEffect();
+void DrawLEDNoiseEffect();
+void DrawLEDNoiseRows(int first, int last, void *context);
+void DrawLEDCycleEffect();
+void DrawLEDPulseEffect();
+void FillLEDRainbowPalette();
 
 //Initialize LED display
 void InitLED()
@@ -66,22 +103,16 @@ void InitLED()
     SetLEDCurrentEffect("DEFAULT");
     SetLEDTravelSpeed(1.0f);
 
-    //intialize FastLED
-    FastLED.addLeds<WS2812, LED_GPIO_PIN, GRB>(leds, LED_NUM_LEDS);
+    //intialize FastLED (through the output stage)
+    InitLEDOutput();
+
+    //row independent effects and compositing use both cores
+    InitParallel();
 
     //set initial brightness
     SetLEDBrightness(ledBrightness);
 
-    #ifdef FASTLEDUTILS_DEBUGMODE
-        if (Serial)
-        {
-            Serial.println("FastLED initialized...");
-            Serial.print("FastLED GPIO pin set to: ");
-            Serial.println(LED_GPIO_PIN);
-            Serial.print("Brightness set to: ");
-            Serial.println(ledBrightness);
-        }
-    #endif
+    LOG_DEBUG("FastLED initialized on GPIO pin %d, brightness %d", LED_GPIO_PIN, ledBrightness);
 }
 
 //Sets which effect should be displayed, optionally choosing parameters
@@ -92,18 +123,50 @@ void SetLEDCurrentEffect(String effect, String parameters)
     ledCurrentEffect.toUpperCase();
     ledCurrentEffectParameters = parameters;
     ledFrameIndex = 0;
-    FastLED.clear();
-    FastLED.show();
 
-    #ifdef FASTLEDUTILS_DEBUGMODE
-        if (Serial)
-        {
-            Serial.print("Current effect set to: ");
-            Serial.println(ledCurrentEffect);
-            Serial.print("Current effect parameters: ");
-            Serial.println(ledCurrentEffectParameters);
-        }
-    #endif
+    //release the animation file of the previous effect
+    StopLEDAnimation();
+
+    //effects draw into the LED array unless they enable the indexed frame
+    SetLEDIndexedEnabled(false);
+
+    //frame costs are measured per effect
+    ResetLEDGovernor();
+    ledFramePeriod = ledFramerate;
+
+    //decode the beat colour once, on activation (invalid colours keep the default)
+    ledBeatColor = CRGB(0, 0, 64);
+    if ((ledCurrentEffect == "BEAT" || ledCurrentEffect == "DEFAULT") && parameters != "")
+    {
+        CRGB color;
+        if (DecodeLEDColors(parameters, &color, 1) == 1)
+            ledBeatColor = color;
+    }
+
+    //compile patterns once, on activation (presets are already compiled, set by SetLEDPatternEffect)
+    ledActivePattern = NULL;
+    if (ledCurrentEffect == "PATTERN" && parameters != "")
+    {
+        int errorPos = 0;
+        if (CompileLEDPattern(parameters.c_str(), parameters.length(), ledCustomPattern, &errorPos))
+            ledActivePattern = &ledCustomPattern;
+        else
+            LOG_WARN("Invalid pattern at position %d", errorPos);
+    }
+
+    //clear strip
+    fill_solid(leds, LED_NUM_LEDS, CRGB::Black);
+    ShowLEDStrip();
+
+    LOG_DEBUG("Current effect set to: %s", ledCurrentEffect.c_str());
+    LOG_DEBUG("Current effect parameters: %.48s", ledCurrentEffectParameters.c_str());
+}
+
+//Displays an already compiled pattern (e.g. a built-in preset), pattern must stay valid
+void SetLEDPatternEffect(const LedPattern *pattern)
+{
+    SetLEDCurrentEffect("Pattern");
+    ledActivePattern = pattern;
 }
 
 //Gets which effect is currently displayed
@@ -118,21 +181,55 @@ String GetLEDCurrentEffectParameters()
     return ledCurrentEffectParameters;    
 }
 
+//Sets how images are fitted onto the matrix
+void SetLEDImageMode(LedImageMode mode)
+{
+    ledImageMode = mode;
+}
+
+//Gets how images are fitted onto the matrix
+LedImageMode GetLEDImageMode()
+{
+    return ledImageMode;
+}
+
+//Sets the image pack the pack effect draws from (mapped, must stay valid)
+void SetLEDImagePack(const ImagePack &pack)
+{
+    ledImagePack = pack;
+}
+
+//Gets the image pack the pack effect draws from, empty if none
+const ImagePack &GetLEDImagePack()
+{
+    return ledImagePack;
+}
+
+//Sets the colour of the text effect
+void SetLEDTextColor(CRGB color)
+{
+    ledTextColor = color;
+}
+
+//Sets whether the pattern effect scrolls one pixel per frame
+void SetLEDPatternScroll(bool scroll)
+{
+    ledPatternScroll = scroll;
+}
+
+//Gets whether the pattern effect scrolls one pixel per frame
+bool GetLEDPatternScroll()
+{
+    return ledPatternScroll;
+}
+
 //Sets the speed which leds should travel in meters per second
 void SetLEDTravelSpeed(float speed_m_per_s)
 {
     ledFramerate = (int) 1000 / speed_m_per_s / LED_PX_PER_METER;
+    ledFramePeriod = ledFramerate;
 
-    #ifdef FASTLEDUTILS_DEBUGMODE
-        if (Serial)
-        {
-            Serial.print("Travel speed set to: ");
-            Serial.print(speed_m_per_s);
-            Serial.print("m/s , Framerate: ");
-            Serial.print(ledFramerate);
-            Serial.println("ms.");
-        }
-    #endif
+    LOG_DEBUG("Travel speed set to: %.2fm/s , Framerate: %ldms.", speed_m_per_s, ledFramerate);
 }
 
 //Gets the speed which leds should travel in meters per second
@@ -159,17 +256,11 @@ void SetLEDBrightness(int brightness)
     else if (ledBrightness > 255)
         ledBrightness = 255;
 
-    //apply it
-    FastLED.setBrightness(ledBrightness);
-    FastLED.show();
+    //apply it (folded into the output LUT), only the LUT changed
+    SetLEDOutputBrightness(ledBrightness);
+    ShowLEDStripChanges();
 
-    #ifdef FASTLEDUTILS_DEBUGMODE
-        if (Serial)
-        {
-            Serial.print("Brightness set to: ");
-            Serial.println(ledBrightness);
-        }
-    #endif
+    LOG_DEBUG("Brightness set to: %d", ledBrightness);
 }
 
 //Gets the relative brightness of the LED strip (0-255)
@@ -185,19 +276,103 @@ void DrawLEDFrame()
     //update current time
     ledCurrentTime = millis();
 
-    //check if it is time to draw
-    if (ledCurrentTime > ledFramerate + ledPreviousTime)
+    //check if it is time to draw (the governor stretches the period of effects too slow for it)
+    if (ledCurrentTime - ledPreviousTime >= (unsigned long) ledFramePeriod)
     {
+        unsigned long start = micros();
+
+        //sprites first, so an effect showing its frame shows them too
+        UpdateLEDSprites(ledCurrentTime);
         DrawLEDCurrentEffectFrame();
 
+        //static effects do not redraw, overlays or output settings may still have changed
+        if (GetLEDLayersChanged() || GetLEDOutputPending())
+            ShowLEDStripChanges();
+
+        ledFramePeriod = UpdateLEDGovernor(micros() - start, ledFramerate);
+
         //update previous time the frame was drawn
         ledPreviousTime = ledCurrentTime;
     }
 }
 
+//Decodes RRGGBB hexadecimal parameters into colours, returns the colour count or -1
+int DecodeLEDColors(const String &hex, CRGB *colors, int maxColors)
+{
+    int errorPos = 0;
+    int count = HexDecodePixels(hex.c_str(), hex.length(), (uint8_t *) colors, maxColors, &errorPos);
+
+    if (count < 0)
+        LOG_WARN("Invalid colour data at position %d of %u", errorPos, hex.length());
+
+    return count;
+}
+
+//Pushes the LED array (or the indexed frame), with the overlays over it, to the strip
+void ShowLEDStrip()
+{
+    if (GetLEDIndexedEnabled())
+    {
+        //without overlays the palette goes straight through the output LUT
+        if (!AnyLEDLayerVisible())
+        {
+            ShowLEDOutputIndexed(GetLEDIndexedFrame(), GetLEDIndexedPalette(), GetLEDIndexedPaletteOffset());
+            return;
+        }
+
+        ExpandLEDIndexedFrame(leds);
+    }
+
+    ShowLEDOutput(CompositeLEDLayers(leds));
+
+    ledDirtyFirst = LED_NUM_LEDS;
+    ledDirtyLast = -1;
+}
+
+//Pushes only the LEDs changed (SetLEDPixel, MarkLEDRegionChanged) since the strip was shown,
+//nothing at all if none changed and the output settings are the same
+void ShowLEDStripChanges()
+{
+    //indexed frames and overlays are converted as a whole
+    if (GetLEDIndexedEnabled() || AnyLEDLayerVisible() || GetLEDLayersChanged())
+    {
+        ShowLEDStrip();
+        return;
+    }
+
+    ShowLEDOutputRange(leds, ledDirtyFirst, ledDirtyLast - ledDirtyFirst + 1);
+
+    ledDirtyFirst = LED_NUM_LEDS;
+    ledDirtyLast = -1;
+}
+
+//Sets one LED, to be pushed by ShowLEDStripChanges
+void SetLEDPixel(int index, CRGB color)
+{
+    if (index < 0 || index >= LED_NUM_LEDS || leds[index] == color)
+        return;
+
+    leds[index] = color;
+    MarkLEDRegionChanged(index, 1);
+}
+
+//Marks LEDs written directly to the LED array, to be pushed by ShowLEDStripChanges
+void MarkLEDRegionChanged(int first, int count)
+{
+    if (count <= 0)
+        return;
+
+    if (first < ledDirtyFirst)
+        ledDirtyFirst = max(first, 0);
+    if (first + count - 1 > ledDirtyLast)
+        ledDirtyLast = min(first + count - 1, LED_NUM_LEDS - 1);
+}
+
 //Draws the next frame for the effect
 void DrawLEDCurrentEffectFrame()
 {
+    TRACE_SCOPE("DrawLEDCurrentEffectFrame");
+
     //choose the right effect
     if (ledCurrentEffect == "RAINBOW")
         DrawLEDRainbowEffect();
@@ -205,8 +380,24 @@ void DrawLEDCurrentEffectFrame()
         DrawLEDSolidEffect();
     else if (ledCurrentEffect == "IMAGE")
         DrawLEDImageEffect();
+    else if (ledCurrentEffect == "ANIMATION")
+        DrawLEDAnimationEffect();
+    else if (ledCurrentEffect == "PACK")
+        DrawLEDPackEffect();
     else if (ledCurrentEffect == "PATTERN")
         DrawLEDPatternEffect();
+    else if (ledCurrentEffect == "TEXT")
+        DrawLEDTextEffect();
+    else if (ledCurrentEffect == "LIFE")
+        DrawLEDLifeEffect();
+    else if (ledCurrentEffect == "FIRE")
+        DrawLEDFireEffect();
+    else if (ledCurrentEffect == "NOISE")
+        DrawLEDNoiseEffect();
+    else if (ledCurrentEffect == "CYCLE")
+        DrawLEDCycleEffect();
+    else if (ledCurrentEffect == "PULSE")
+        DrawLEDPulseEffect();
     else
         DrawLEDBeatEffect(); //Default to beat effect
 
@@ -217,19 +408,15 @@ void DrawLEDBeatEffect()
 {
     static bool isReverse = false;
 
-    //set default beat color
-    CRGB targetColor = CRGB(0, 0, 64);
-
-    //override default color if specified
-    if (ledCurrentEffectParameters != "")
-        targetColor = CRGB(HexStrToInt(ledCurrentEffectParameters));
+    //decoded by SetLEDCurrentEffect
+    CRGB targetColor = ledBeatColor;
 
     if (!isReverse)
     {
         //FORWARD       
         
         //light new led
-        leds[ledFrameIndex] = targetColor;
+        SetLEDPixel(ledFrameIndex, targetColor);
 
         //cehck if we reached the end
         if (ledFrameIndex >= LED_NUM_LEDS-1)
@@ -249,7 +436,7 @@ void DrawLEDBeatEffect()
         //BACKWARDS
 
         //turn-off led
-        leds[ledFrameIndex] = CRGB::Black;
+        SetLEDPixel(ledFrameIndex, CRGB::Black);
 
         //cehck if we reached the start
         if (ledFrameIndex <= 0)
@@ -265,8 +452,8 @@ void DrawLEDBeatEffect()
         }
     }
 
-    //update strip
-    FastLED.show();
+    //update strip, a single LED changed
+    ShowLEDStripChanges();
 }
 
 
@@ -298,7 +485,7 @@ void DrawLEDRainbowEffect()
     }
     
     //display on LED strip
-    FastLED.show();
+    ShowLEDStrip();
 
     if (isReverse)
     {
@@ -326,31 +513,20 @@ void DrawLEDSolidEffect()
     //only need to do this once really
     if (ledFrameIndex == 0)
     {
-        // uint32_t targetColor = ledCurrentEffectParameters.toInt();
-
-        // //Convert HEX parameter to INT
-        // char c[7] = "000000";
-        // ledCurrentEffectParameters.toCharArray(c, 7);
-        // targetColor = HexStrToInt(c);
+        //invalid colours turn the strip off
+        CRGB targetColor = CRGB::Black;
+        DecodeLEDColors(ledCurrentEffectParameters, &targetColor, 1);
 
-        uint32_t targetColor = HexStrToInt(ledCurrentEffectParameters);
-
-        #ifdef FASTLEDUTILS_DEBUGMODE
-            if (Serial)
-            {
-                Serial.print("Color set to: ");
-                Serial.println(targetColor, HEX);
-            }
-        #endif
+        LOG_DEBUG("Color set to: %02X%02X%02X", targetColor.r, targetColor.g, targetColor.b);
 
         //set all LEDS
         for (int i = 0; i <= LED_NUM_LEDS-1; i++) {
             //light new pixel
-            leds[i] = CRGB(targetColor);
+            leds[i] = targetColor;
         }
 
         //update strip
-        FastLED.show();
+        ShowLEDStrip();
 
         //change frame
         ledFrameIndex = 1;
@@ -359,126 +535,419 @@ void DrawLEDSolidEffect()
 
 void DrawLEDPatternEffect()
 {
-    //only need to do this once really
+    const LedPattern *pattern = ledActivePattern;
+
+    //nothing valid to display
+    if (pattern == NULL || pattern->length == 0)
+        return;
+
     if (ledFrameIndex == 0)
     {
-        int patternLength = ledCurrentEffectParameters.length() / 6;
-        uint32_t patternArray[patternLength];
+        LOG_DEBUG("Pattern of %d pixels using %d colors", pattern->length, pattern->paletteSize);
 
-        //extract pattern from param
-        for (int i=0; i<patternLength; i++)
+        //set all LEDS, repeating the pattern (the last repeat may be partial)
+        int j = 0;
+        for (int i = 0; i < LED_NUM_LEDS; i++)
         {
-            int start = i*6;
-            int end = start+6;
-            String patternPixel = ledCurrentEffectParameters.substring(start, end);
-            uint32_t pixelColor = HexStrToInt(patternPixel);
-            patternArray[i] = pixelColor;
+            leds[i] = CRGB(pattern->palette[pattern->indexes[j]]);
+
+            if (++j == pattern->length)
+                j = 0;
         }
 
-        #ifdef FASTLEDUTILS_DEBUGMODE
-            if (Serial)
-            {
-                Serial.print("Pattern \"");
-                Serial.print(ledCurrentEffectParameters);
-                Serial.println("\" converted to:");
-                for (int i=0; i<patternLength; i++)
-                {
-                    Serial.print(patternArray[i], HEX);
-                    Serial.print(",");
-                }
-                Serial.println("");
-            }
-        #endif
+        ledPatternPhase = 0;
 
-        //clear strip
-        FastLED.clear();
+        //update strip
+        ShowLEDStrip();
 
-        //set all LEDS
-        for (int i = 0; i <= LED_NUM_LEDS-1; i+=patternLength) 
+        //change frame
+        ledFrameIndex = 1;
+    }
+    else if (ledPatternScroll)
+    {
+        //shift everything one pixel down the strip and only compute the new first pixel
+        memmove(&leds[1], &leds[0], (LED_NUM_LEDS - 1) * sizeof(CRGB));
+
+        ledPatternPhase = (ledPatternPhase + pattern->length - 1) % pattern->length;
+        leds[0] = CRGB(pattern->palette[pattern->indexes[ledPatternPhase]]);
+
+        //update strip
+        ShowLEDStrip();
+    }
+}
+
+void DrawLEDImageEffect()
+{
+    //only need to do this once really
+    if (ledFrameIndex == 0)
+    {
+        //change frame
+        ledFrameIndex = 1;
+
+        LOG_DEBUG("Load image data...");
+
+        //decode in the image's own size, then fit it onto the matrix
+        LedImage image = { 0, 0, ledImagePixels };
+        int errorPos = 0;
+
+        if (!DecodeLEDImage(ledCurrentEffectParameters.c_str(), ledCurrentEffectParameters.length(), image, LED_IMAGE_MAX_PIXELS, &errorPos))
         {
-            //light segement
-            for (int j=0; j<patternLength; j++)
-            {
-                leds[i+j] = CRGB(patternArray[j]);
-            }
-            
+            LOG_WARN("Invalid image data at position %d of %u", errorPos, ledCurrentEffectParameters.length());
+            return;
         }
 
+        BlitLEDImage(image, leds, ledImageMode);
+
+        LOG_DEBUG("Image %dx%d drawn (%s)", image.width, image.height, GetLEDImageModeName(ledImageMode));
+
         //update strip
-        FastLED.show();
+        ShowLEDStrip();
+    }
+}
+
+// ANIMATION EFFECT
+//Parameters hold the path of the animation file, frames are streamed from it
+void DrawLEDAnimationEffect()
+{
+    if (ledFrameIndex == 0)
+    {
+        //change frame
+        ledFrameIndex = 1;
+
+        if (!StartLEDAnimation(ledCurrentEffectParameters))
+            return;
+    }
+
+    //frames have their own timing, the strip is only updated when one is drawn
+    if (UpdateLEDAnimation(ledCurrentTime, leds, ledImageMode))
+        ShowLEDStrip();
+}
 
+// PACK EFFECT
+//Parameters hold the name of a pack image, frames are drawn straight from the mapped pack
+void DrawLEDPackEffect()
+{
+    if (ledFrameIndex == 0)
+    {
         //change frame
         ledFrameIndex = 1;
+
+        int index = FindImagePackEntry(ledImagePack, ledCurrentEffectParameters.c_str());
+        if (!GetImagePackEntry(ledImagePack, index, ledPackImage))
+        {
+            LOG_WARN("Image %s not in the image pack", ledCurrentEffectParameters.c_str());
+            ledPackImage.frames = 0;
+            return;
+        }
+
+        ledPackFrame = 0;
+        DrawLEDPackFrame();
+    }
+    else if (ledPackImage.frames > 1 && ledCurrentTime - ledPackFrameTime >= GetImagePackDuration(ledPackImage, ledPackFrame))
+    {
+        ledPackFrame = (ledPackFrame + 1) % ledPackImage.frames;
+        DrawLEDPackFrame();
     }
 }
 
-void DrawLEDImageEffect()
+//Draws the current frame of the pack image
+void DrawLEDPackFrame()
 {
-    //only need to do this once really
+    //pixels are only read, straight from flash
+    LedImage image = { ledPackImage.width, ledPackImage.height, (CRGB *) GetImagePackFrame(ledPackImage, ledPackFrame) };
+    BlitLEDImage(image, leds, ledImageMode);
+
+    ledPackFrameTime = ledCurrentTime;
+
+    //update strip
+    ShowLEDStrip();
+}
+
+// TEXT EFFECT
+//Shifts the rows of the text band one column to the left, following the matrix mapping
+void ShiftLEDTextBand(int top)
+{
+    for (int y = top; y < top + LED_FONT_HEIGHT && y < LED_MATRIX_HEIGHT; y++)
+    {
+        //rows are contiguous on the strip, only their direction varies
+        CRGB *row = &leds[y * LED_MATRIX_WIDTH];
+
+        if (LEDMatrixXY(1, y) > LEDMatrixXY(0, y))
+            memmove(&row[0], &row[1], (LED_MATRIX_WIDTH - 1) * sizeof(CRGB));
+        else
+            memmove(&row[1], &row[0], (LED_MATRIX_WIDTH - 1) * sizeof(CRGB));
+    }
+}
+
+void DrawLEDTextEffect()
+{
+    const String &text = ledCurrentEffectParameters;
+    int top = (LED_MATRIX_HEIGHT - LED_FONT_HEIGHT) / 2;
+
+    //text followed by a blank matrix width, then it starts over
+    int glyphColumns = LED_FONT_WIDTH + 1;
+    int totalColumns = text.length() * glyphColumns + LED_MATRIX_WIDTH;
+
     if (ledFrameIndex == 0)
     {
-        //LINK Frame 1
-        int frames[1][16][16];
+        ledTextColumn = 0;
+        ledFrameIndex = 1;
+    }
 
-        //load data into matrix
-        
-        #ifdef FASTLEDUTILS_DEBUGMODE
-            if (Serial)
-            {
-                Serial.println("Load image data...");
-            }
-        #endif
-
-        int kk=0;
-        for (int i = 0; i <= 15; i++) {
-            for (int j = 0; j <= 15; j++) {
-                //set matrix color value
-                String hexVal = ledCurrentEffectParameters.substring(kk, kk+6);
-                int intVal = HexStrToInt(hexVal);
-                frames[0][i][j] = intVal;
-
-                //too much details
-                /*
-                #ifdef FASTLEDUTILS_DEBUGMODE
-                    if (Serial)
-                    {
-                        Serial.print("HEX:");
-                        Serial.print(hexVal);
-                        Serial.print(" INT:");
-                        Serial.println(intVal);
-                    }
-                #endif
-                */
-
-                //each color value is six bytes (ex: 0xBBEEFF)
-                kk += 6;
-            }
+    //only the newly revealed column is rendered
+    ShiftLEDTextBand(top);
+
+    int character = ledTextColumn / glyphColumns;
+    int column = ledTextColumn % glyphColumns;
+    const uint8_t *glyph = NULL;
+
+    if (character < (int) text.length() && column < LED_FONT_WIDTH)
+        glyph = GetLEDFontGlyph(text[character]);
+
+    for (int row = 0; row < LED_FONT_HEIGHT && top + row < LED_MATRIX_HEIGHT; row++)
+    {
+        bool lit = glyph != NULL && GetLEDFontPixel(glyph, column, row);
+        leds[LEDMatrixXY(LED_MATRIX_WIDTH - 1, top + row)] = lit ? ledTextColor : CRGB(CRGB::Black);
+    }
+
+    ledTextColumn = (ledTextColumn + 1) % totalColumns;
+
+    //update strip, only the text band moved
+    int bottom = min(top + LED_FONT_HEIGHT, LED_MATRIX_HEIGHT);
+    MarkLEDRegionChanged(top * LED_MATRIX_WIDTH, (bottom - top) * LED_MATRIX_WIDTH);
+    ShowLEDStripChanges();
+}
+
+// LIFE EFFECT
+//Starts a new random population
+void SeedLEDLife()
+{
+    if (ledLifeRng == 0)
+        ledLifeRng = random(1, 0x7FFFFFFF);
+
+    LifeSeed(ledLifeRows[ledLifeCurrent], LED_MATRIX_WIDTH, LED_MATRIX_HEIGHT, ledLifeRng, LED_LIFE_DENSITY);
+
+    //ages restart from 0, so the cells drawn so far must go
+    memset(ledLifeAge, 0, sizeof(ledLifeAge));
+    fill_solid(leds, LED_NUM_LEDS, CRGB::Black);
+    memset(ledLifeHistory, 0, sizeof(ledLifeHistory));
+    ledLifeStagnant = 0;
+    ledLifePopulation = 0;
+}
+
+void DrawLEDLifeEffect()
+{
+    #if LED_MATRIX_WIDTH <= LIFE_MAX_WIDTH
+        if (ledFrameIndex == 0)
+        {
+            SeedLEDLife();
+            ledFrameIndex = 1;
+        }
+        else
+        {
+            LifeStep(ledLifeRows[ledLifeCurrent], ledLifeRows[1 - ledLifeCurrent], LED_MATRIX_WIDTH, LED_MATRIX_HEIGHT);
+            ledLifeCurrent = 1 - ledLifeCurrent;
         }
 
-        int k=0;
+        const uint32_t *rows = ledLifeRows[ledLifeCurrent];
 
-        //set matrix
-        //  right to left (interlaced: meaning next row is left to right, and so on...)
-        //  top to bottom
-        for (int i = 0; i <= 15; i++) {
-            for (int j = 0; j <= 15; j++) {
-                
-                if (i == 0 || i % 2 == 0)
-                    leds[k] = CRGB(frames[0][i][15-j]);
-                else
-                    leds[k] = CRGB(frames[0][i][j]);
+        //stagnation: a generation seen recently (still life, short oscillator) or a steady population
+        uint32_t hash = LifeHash(rows, LED_MATRIX_HEIGHT);
+        int population = LifePopulation(rows, LED_MATRIX_HEIGHT);
+        bool repeated = population == ledLifePopulation;
+        for (int i = 0; i < LED_LIFE_HISTORY; i++)
+            repeated |= ledLifeHistory[i] == hash;
+
+        ledLifeStagnant = repeated ? ledLifeStagnant + 1 : 0;
+        ledLifePopulation = population;
+        memmove(&ledLifeHistory[1], &ledLifeHistory[0], (LED_LIFE_HISTORY - 1) * sizeof(uint32_t));
+        ledLifeHistory[0] = hash;
+
+        if (population == 0 || ledLifeStagnant >= LED_LIFE_STAGNANT_GENERATIONS)
+        {
+            SeedLEDLife();
+            rows = ledLifeRows[ledLifeCurrent];
+        }
 
-                k++;
+        //newborn cells are green, turning red as they get older
+        for (int y = 0; y < LED_MATRIX_HEIGHT; y++)
+        {
+            uint32_t row = rows[y];
+
+            for (int x = 0; x < LED_MATRIX_WIDTH; x++)
+            {
+                uint8_t &age = ledLifeAge[y][x];
+
+                if ((row >> x) & 1)
+                {
+                    if (age < 255)
+                        age++;
+                    uint8_t hue = (age < 32) ? 96 - age * 3 : 0;
+                    leds[LEDMatrixXY(x, y)] = CHSV(hue, 255, 255);
+                }
+                else if (age != 0)
+                {
+                    age = 0;
+                    leds[LEDMatrixXY(x, y)] = CRGB::Black;
+                }
             }
         }
+    #else
+        //rows are packed in a single word
+        if (ledFrameIndex == 0)
+        {
+            LOG_WARN("Life effect needs a matrix at most %d wide", LIFE_MAX_WIDTH);
+            ledFrameIndex = 1;
+        }
+    #endif
 
-        //try to tame brightness
-        SetLEDBrightness(16);
+    //update strip
+    ShowLEDStrip();
+}
 
-        //update strip
-        FastLED.show();
+// FIRE EFFECT
+void DrawLEDFireEffect()
+{
+    uint8_t *frame = GetLEDIndexedFrame();
 
-        //change frame
+    if (ledFrameIndex == 0)
+    {
+        memset(ledFxValues, 0, sizeof(ledFxValues));
+        if (ledFxRng == 0)
+            ledFxRng = random(1, 0x7FFFFFFF);
+        ledFrameIndex = 1;
+
+        //heat is the palette index: black, red, yellow, white
+        SetLEDIndexedEnabled(true);
+        CRGB *palette = GetLEDIndexedPalette();
+        for (int i = 0; i < 256; i++)
+            palette[i] = HeatColor(i);
+    }
+
+    FireStep(ledFxValues, LED_MATRIX_WIDTH, LED_MATRIX_HEIGHT, LED_FIRE_COOLING, LED_FIRE_SPARKING, ledFxRng);
+
+    const uint8_t *heat = ledFxValues;
+    for (int y = 0; y < LED_MATRIX_HEIGHT; y++)
+        for (int x = 0; x < LED_MATRIX_WIDTH; x++)
+            frame[LEDMatrixXY(x, y)] = *heat++;
+
+    //update strip
+    ShowLEDStrip();
+}
+
+// NOISE EFFECT
+void DrawLEDNoiseEffect()
+{
+    if (ledFrameIndex == 0)
+    {
+        SetLEDIndexedEnabled(true);
+        FillLEDRainbowPalette();
+    }
+
+    //drift through the noise field, slowly rotating the hues
+    uint16_t t = ledFrameIndex++;
+
+    //rows are independent, split between both cores
+    ParallelForRows(LED_MATRIX_HEIGHT, DrawLEDNoiseRows, &t);
+
+    //the noise value is the hue, the hue rotation is the palette rotation
+    SetLEDIndexedPaletteOffset(t >> 2);
+
+    //update strip
+    ShowLEDStrip();
+}
+
+//Noise values and indices of rows [first, last) at time *context
+void DrawLEDNoiseRows(int first, int last, void *context)
+{
+    uint16_t t = *(const uint16_t *) context;
+    uint8_t *frame = GetLEDIndexedFrame();
+    uint8_t *values = ledFxValues + first * LED_MATRIX_WIDTH;
+
+    NoiseFillRows(ledFxValues, LED_MATRIX_WIDTH, first, last, t * 3, t * 2, t * LED_NOISE_SPEED, LED_NOISE_SCALE);
+
+    for (int y = first; y < last; y++)
+        for (int x = 0; x < LED_MATRIX_WIDTH; x++)
+            frame[LEDMatrixXY(x, y)] = *values++;
+}
+
+// CYCLE EFFECT
+//Fills the indexed palette with the hue wheel
+void FillLEDRainbowPalette()
+{
+    CRGB *palette = GetLEDIndexedPalette();
+
+    for (int i = 0; i < 256; i++)
+        palette[i] = CHSV(i, 255, 255);
+}
+
+//Diagonal rainbow drawn once, then animated by rotating the palette only
+void DrawLEDCycleEffect()
+{
+    if (ledFrameIndex == 0)
+    {
+        ledFrameIndex = 1;
+
+        SetLEDIndexedEnabled(true);
+        FillLEDRainbowPalette();
+
+        //one full hue wheel across the diagonal
+        uint8_t *frame = GetLEDIndexedFrame();
+        for (int y = 0; y < LED_MATRIX_HEIGHT; y++)
+            for (int x = 0; x < LED_MATRIX_WIDTH; x++)
+                frame[LEDMatrixXY(x, y)] = (x + y) * 256 / (LED_MATRIX_WIDTH + LED_MATRIX_HEIGHT);
+    }
+
+    RotateLEDIndexedPalette(1);
+
+    //update strip
+    ShowLEDStrip();
+}
+
+// PULSE EFFECT
+//Rings of colour moving out of the centre: the index is the distance, the palette a brightness wave
+void DrawLEDPulseEffect()
+{
+    if (ledFrameIndex == 0)
+    {
         ledFrameIndex = 1;
+
+        CRGB color = CRGB(255, 0, 64);
+        if (ledCurrentEffectParameters != "")
+            DecodeLEDColors(ledCurrentEffectParameters, &color, 1);
+
+        SetLEDIndexedEnabled(true);
+
+        //two rings over the palette: brightness rises then falls twice
+        CRGB *palette = GetLEDIndexedPalette();
+        for (int i = 0; i < 256; i++)
+        {
+            uint8_t phase = i * 2;
+            uint8_t level = (phase < 128) ? phase * 2 : (255 - phase) * 2;
+            palette[i] = CRGB((color.r * level) >> 8, (color.g * level) >> 8, (color.b * level) >> 8);
+        }
+
+        //distance to the centre, 16 palette entries per LED, fewer on large matrices so the corners stay within 255
+        float centreX = (LED_MATRIX_WIDTH - 1) / 2.0f;
+        float centreY = (LED_MATRIX_HEIGHT - 1) / 2.0f;
+        float maxRadius = sqrtf(centreX * centreX + centreY * centreY);
+        float step = (maxRadius * 16 > 255) ? 255 / maxRadius : 16;
+
+        uint8_t *frame = GetLEDIndexedFrame();
+        for (int y = 0; y < LED_MATRIX_HEIGHT; y++)
+        {
+            for (int x = 0; x < LED_MATRIX_WIDTH; x++)
+            {
+                float dx = x - centreX;
+                float dy = y - centreY;
+                frame[LEDMatrixXY(x, y)] = (uint8_t) min(255.0f, sqrtf(dx * dx + dy * dy) * step);
+            }
+        }
     }
+
+    //decreasing offset: a colour moves to higher indices, away from the centre
+    RotateLEDIndexedPalette(-4);
+
+    //update strip
+    ShowLEDStrip();
 }
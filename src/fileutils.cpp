@@ -13,10 +13,13 @@
 #include <fileutils.h>
 #include <SPIFFS.h>
 #include <arduinoutils.h>
+#include <traceutils.h>
 
 //Reads the contents of a file as a string, or empty string on error
 String FSReadFile(String filePath)
 {
+    TRACE_SCOPE("FSReadFile");
+
     String ret = "";
 
     if(!SPIFFS.begin(true)){
@@ -60,6 +63,8 @@ String FSReadFile(String filePath)
 //Writes a string to a file, returns file size or -1 if failed
 int FSWriteFile(String filePath, String fileData)
 {
+    TRACE_SCOPE("FSWriteFile");
+
     //default to fail
     int ret = -1;
 
@@ -116,6 +121,8 @@ int FSWriteFile(String filePath, String fileData)
 //Deletes a file, returns True if successful
 bool FSDeleteFile(String filePath)
 {
+    TRACE_SCOPE("FSDeleteFile");
+
     //assume operation will fail.
     bool ret = false;
 
@@ -157,6 +164,8 @@ bool FSDeleteFile(String filePath)
 //Test if a file exists
 bool FSFileExists(String filePath)
 {
+    TRACE_SCOPE("FSFileExists");
+
     //assume operation will fail.
     bool ret = false;
 
@@ -0,0 +1,165 @@
+//+--------------------------------------------------------------------------
+//
+// File:        fxutils.cpp
+//
+// Description: The purpose of this file is to provide the integer kernels
+//              of the organic effects: a per column heat diffusion fire and
+//              8 bit gradient noise. Both walk their grid row by row, in
+//              memory order, with no floating point.
+//
+// History:     2026-10-18    PP Laplante   Created
+//
+//
+//---------------------------------------------------------------------------
+#include <fxutils.h>
+
+//Ken Perlin's permutation, indexes wrap on 8 bits
+static const uint8_t noisePermutation[256] =
+{
+    151,160,137,91,90,15,131,13,201,95,96,53,194,233,7,225,140,36,103,30,69,142,8,99,37,240,21,10,23,
+    190,6,148,247,120,234,75,0,26,197,62,94,252,219,203,117,35,11,32,57,177,33,88,237,149,56,87,174,20,
+    125,136,171,168,68,175,74,165,71,134,139,48,27,166,77,146,158,231,83,111,229,122,60,211,133,230,220,
+    105,92,41,55,46,245,40,244,102,143,54,65,25,63,161,1,216,80,73,209,76,132,187,208,89,18,169,200,196,
+    135,130,116,188,159,86,164,100,109,198,173,186,3,64,52,217,226,250,124,123,5,202,38,147,118,126,255,
+    82,85,212,207,206,59,227,47,16,58,17,182,189,28,42,223,183,170,213,119,248,152,2,44,154,163,70,221,
+    153,101,155,167,43,172,9,129,22,39,253,19,98,108,110,79,113,224,232,178,185,112,104,218,246,97,228,
+    251,34,242,193,238,210,144,12,191,179,162,241,81,51,145,235,249,14,239,107,49,192,214,31,181,199,
+    106,157,184,84,204,176,115,121,50,45,127,4,150,254,138,236,205,93,222,114,67,29,24,72,243,141,128,
+    195,78,66,215,61,156,180
+};
+
+//Next value of a xorshift generator
+static inline uint32_t FxRandom(uint32_t &rng)
+{
+    rng ^= rng << 13;
+    rng ^= rng >> 17;
+    rng ^= rng << 5;
+    return rng;
+}
+
+//Saturating subtraction
+static inline uint8_t QSub8(uint8_t a, uint8_t b)
+{
+    return (a > b) ? a - b : 0;
+}
+
+//Advances a fire simulation: heat rises from the bottom row, cooling and sparking 0-255
+void FireStep(uint8_t *heat, int width, int height, uint8_t cooling, uint8_t sparking, uint32_t &rng)
+{
+    if (rng == 0)
+        rng = 0x2545F491u;
+
+    //cool every cell a little, one random byte per cell
+    uint32_t maxCooling = (cooling * 10u) / height + 2;
+    for (int i = 0; i < width * height; i++)
+        heat[i] = QSub8(heat[i], (uint8_t) ((FxRandom(rng) >> 24) * maxCooling >> 8));
+
+    //heat drifts up: each row is fed by the two rows below, not yet updated when read
+    for (int y = 0; y < height - 2; y++)
+    {
+        uint8_t *row = heat + y * width;
+        const uint8_t *below1 = row + width;
+        const uint8_t *below2 = row + 2 * width;
+
+        for (int x = 0; x < width; x++)
+            row[x] = (uint8_t) ((below1[x] + 2u * below2[x]) / 3);
+    }
+
+    //ignite new sparks near the bottom
+    uint8_t *bottom = heat + (height - 1) * width;
+    for (int x = 0; x < width; x++)
+    {
+        uint32_t r = FxRandom(rng);
+
+        if ((r >> 24) < sparking)
+        {
+            uint16_t spark = bottom[x] + 160 + ((r >> 8) & 0x5F);
+            bottom[x] = (spark > 255) ? 255 : spark;
+        }
+    }
+}
+
+//Quadratic ease in/out of a 0-255 fraction
+static inline uint8_t Ease8(uint8_t t)
+{
+    if (t < 128)
+        return (t * t) >> 7;
+
+    uint8_t r = 255 - t;
+    return 255 - ((r * r) >> 7);
+}
+
+//Interpolates two signed values with a 0-255 fraction
+static inline int16_t Lerp(int16_t a, int16_t b, uint8_t t)
+{
+    return a + (((b - a) * t) >> 8);
+}
+
+//Dot product of one of 12 gradient directions with the offset, offsets are -128..127
+static inline int16_t Grad8(uint8_t hash, int16_t x, int16_t y, int16_t z)
+{
+    hash &= 0x0F;
+
+    int16_t u = (hash < 8) ? x : y;
+    int16_t v = (hash < 4) ? y : (hash == 12 || hash == 14) ? x : z;
+
+    if (hash & 1)
+        u = -u;
+    if (hash & 2)
+        v = -v;
+
+    return (u + v) >> 1;
+}
+
+//3D gradient noise on 8.8 fixed point coordinates, returns 0-255 (inoise8 style)
+uint8_t Noise8(uint16_t x, uint16_t y, uint16_t z)
+{
+    const uint8_t *P = noisePermutation;
+
+    //integer cell and fraction
+    uint8_t X = x >> 8, Y = y >> 8, Z = z >> 8;
+    uint8_t fx = x & 0xFF, fy = y & 0xFF, fz = z & 0xFF;
+
+    //hash the 8 corners
+    uint8_t A = P[X] + Y;
+    uint8_t AA = P[A] + Z;
+    uint8_t AB = P[(uint8_t) (A + 1)] + Z;
+    uint8_t B = P[(uint8_t) (X + 1)] + Y;
+    uint8_t BA = P[B] + Z;
+    uint8_t BB = P[(uint8_t) (B + 1)] + Z;
+
+    uint8_t u = Ease8(fx), v = Ease8(fy), w = Ease8(fz);
+
+    //offsets to the near (0..127) and far (-128..-1) corners
+    int16_t x0 = fx >> 1, y0 = fy >> 1, z0 = fz >> 1;
+    int16_t x1 = x0 - 128, y1 = y0 - 128, z1 = z0 - 128;
+
+    int16_t n = Lerp(Lerp(Lerp(Grad8(P[AA], x0, y0, z0), Grad8(P[BA], x1, y0, z0), u),
+                          Lerp(Grad8(P[AB], x0, y1, z0), Grad8(P[BB], x1, y1, z0), u), v),
+                     Lerp(Lerp(Grad8(P[(uint8_t) (AA + 1)], x0, y0, z1), Grad8(P[(uint8_t) (BA + 1)], x1, y0, z1), u),
+                          Lerp(Grad8(P[(uint8_t) (AB + 1)], x0, y1, z1), Grad8(P[(uint8_t) (BB + 1)], x1, y1, z1), u), v),
+                     w);
+
+    //about -64..64 in practice, stretched to the full byte
+    int16_t result = (n + 64) * 2;
+    return (result < 0) ? 0 : (result > 255) ? 255 : result;
+}
+
+//Fills a grid with noise, stepping scale (8.8) per cell from (x, y) at depth z
+void NoiseFill(uint8_t *values, int width, int height, uint16_t x, uint16_t y, uint16_t z, uint16_t scale)
+{
+    NoiseFillRows(values, width, 0, height, x, y, z, scale);
+}
+
+//Fills rows [first, last) of a grid like NoiseFill does, so row jobs match a whole fill
+void NoiseFillRows(uint8_t *values, int width, int first, int last, uint16_t x, uint16_t y, uint16_t z, uint16_t scale)
+{
+    for (int j = first; j < last; j++)
+    {
+        uint16_t ny = y + j * scale;
+        uint8_t *row = values + j * width;
+
+        for (int i = 0; i < width; i++)
+            row[i] = Noise8(x + i * scale, ny, z);
+    }
+}
@@ -0,0 +1,151 @@
+//+--------------------------------------------------------------------------
+//
+// File:        hexutils.cpp
+//
+// Description: The purpose of this file is to provide bulk hexadecimal
+//              decoding of colour data without per-pixel allocations.
+//              Full 8 character blocks are validated and converted with
+//              SWAR (SIMD within a register) arithmetic on a 64-bit word,
+//              the remainder goes through a lookup table.
+//
+// History:     2026-10-18    PP Laplante   Created
+//
+//
+//---------------------------------------------------------------------------
+#include <string.h>
+#include <hexutils.h>
+
+#define HEX_INVALID     0xFF
+
+//nibble value of each ASCII character, HEX_INVALID if not hexadecimal
+static uint8_t hexTable[256];
+static bool hexTableReady = false;
+
+//Builds the lookup table on first use
+static void InitHexTable()
+{
+    memset(hexTable, HEX_INVALID, sizeof(hexTable));
+
+    for (int i = 0; i < 10; i++)
+        hexTable['0' + i] = i;
+
+    for (int i = 0; i < 6; i++)
+    {
+        hexTable['A' + i] = 10 + i;
+        hexTable['a' + i] = 10 + i;
+    }
+
+    hexTableReady = true;
+}
+
+#if defined(__BYTE_ORDER__) && __BYTE_ORDER__ == __ORDER_LITTLE_ENDIAN__
+#define HEX_SWAR 1
+
+static const uint64_t SWAR_ONES = 0x0101010101010101ULL;
+static const uint64_t SWAR_HIGH = 0x8080808080808080ULL;
+
+//High bit set in each byte of x within [lo, hi] - bytes must be below 0x80
+static inline uint64_t SwarInRange(uint64_t x, uint8_t lo, uint8_t hi)
+{
+    //no carry can cross lanes: every lane stays below 0x100
+    uint64_t geLo = (x + SWAR_ONES * (0x80 - lo)) & SWAR_HIGH;
+    uint64_t leHi = ~(x + SWAR_ONES * (0x7F - hi)) & SWAR_HIGH;
+
+    return geLo & leHi;
+}
+
+//Converts 8 hexadecimal characters into 4 bytes, returns the index of the first invalid character or -1
+static inline int SwarDecode8(const char *hex, uint8_t *out)
+{
+    uint64_t x;
+    memcpy(&x, hex, 8);
+
+    //validate: '0'-'9', 'A'-'F' or 'a'-'f', lanes with the high bit set are never valid
+    uint64_t ascii = x & ~SWAR_HIGH;
+    uint64_t valid = SwarInRange(ascii, '0', '9') | SwarInRange(ascii, 'A', 'F') | SwarInRange(ascii, 'a', 'f');
+    valid &= ~x;
+
+    if (valid != SWAR_HIGH)
+    {
+        uint64_t invalid = ~valid & SWAR_HIGH;
+        return __builtin_ctzll(invalid) / 8;
+    }
+
+    //letters have bit 6 set: nibble = low 4 bits + 9
+    uint64_t nibbles = (x & (SWAR_ONES * 0x0F)) + ((x >> 6) & SWAR_ONES) * 9;
+
+    //pair nibbles: first character is the high nibble of each byte
+    uint64_t pairs = ((nibbles << 4) | (nibbles >> 8)) & 0x00FF00FF00FF00FFULL;
+
+    out[0] = (uint8_t) pairs;
+    out[1] = (uint8_t) (pairs >> 16);
+    out[2] = (uint8_t) (pairs >> 32);
+    out[3] = (uint8_t) (pairs >> 48);
+
+    return -1;
+}
+#endif
+
+//Decodes hexadecimal text into bytes, 8 characters at a time
+int HexDecode(const char *hex, size_t hexLength, uint8_t *out, size_t outSize, int *errorPos)
+{
+    if (!hexTableReady)
+        InitHexTable();
+
+    //odd length or too long: report the first character that does not fit
+    if (hexLength % 2 != 0 || hexLength / 2 > outSize)
+    {
+        if (errorPos != NULL)
+            *errorPos = (hexLength / 2 > outSize) ? outSize * 2 : hexLength - 1;
+        return -1;
+    }
+
+    size_t i = 0;
+
+    #ifdef HEX_SWAR
+        for (; i + 8 <= hexLength; i += 8)
+        {
+            int bad = SwarDecode8(hex + i, out + i / 2);
+            if (bad >= 0)
+            {
+                if (errorPos != NULL)
+                    *errorPos = i + bad;
+                return -1;
+            }
+        }
+    #endif
+
+    //remainder (or everything on big endian targets)
+    for (; i < hexLength; i += 2)
+    {
+        uint8_t hi = hexTable[(uint8_t) hex[i]];
+        uint8_t lo = hexTable[(uint8_t) hex[i + 1]];
+
+        if (hi == HEX_INVALID || lo == HEX_INVALID)
+        {
+            if (errorPos != NULL)
+                *errorPos = (hi == HEX_INVALID) ? i : i + 1;
+            return -1;
+        }
+
+        out[i / 2] = (hi << 4) | lo;
+    }
+
+    return hexLength / 2;
+}
+
+//Decodes RRGGBB hexadecimal text into 3 byte pixels (CRGB layout)
+int HexDecodePixels(const char *hex, size_t hexLength, uint8_t *rgb, size_t maxPixels, int *errorPos)
+{
+    //partial pixels are an error
+    if (hexLength % 6 != 0)
+    {
+        if (errorPos != NULL)
+            *errorPos = hexLength - hexLength % 6;
+        return -1;
+    }
+
+    int bytes = HexDecode(hex, hexLength, rgb, maxPixels * 3, errorPos);
+
+    return (bytes < 0) ? -1 : bytes / 3;
+}
@@ -0,0 +1,192 @@
+//+--------------------------------------------------------------------------
+//
+// File:        imagepack.cpp
+//
+// Description: The purpose of this file is to provide reading of image
+//              packs: read only images in a flash partition, mapped into
+//              the address space so frames are drawn straight from flash,
+//              without file handles, parsing or heap. On the host the same
+//              pack is mapped from a file.
+//
+// History:     2026-10-18    PP Laplante   Created
+//
+//
+//---------------------------------------------------------------------------
+#include <string.h>
+#include <imagepack.h>
+
+#ifdef ESP32
+#include <esp_partition.h>
+#include <esp_spi_flash.h>
+#else
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+#endif
+
+#define PACK_HEADER_SIZE    16
+#define PACK_ENTRY_SIZE     40
+
+//Reads little endian values, whatever the alignment
+static inline uint16_t ReadPack16(const uint8_t *p)
+{
+    return p[0] | (p[1] << 8);
+}
+
+static inline uint32_t ReadPack32(const uint8_t *p)
+{
+    return p[0] | (p[1] << 8) | (p[2] << 16) | ((uint32_t) p[3] << 24);
+}
+
+//Checks a pack and its whole index, returns false if anything points outside of it
+bool OpenImagePack(const uint8_t *data, size_t size, ImagePack &pack)
+{
+    pack.data = NULL;
+    pack.size = 0;
+    pack.count = 0;
+
+    if (data == NULL || size < PACK_HEADER_SIZE || memcmp(data, "LIPK", 4) != 0 || ReadPack16(data + 4) != IMAGE_PACK_VERSION)
+        return false;
+
+    uint16_t count = ReadPack16(data + 6);
+    uint32_t packSize = ReadPack32(data + 8);
+
+    //the partition is usually larger than the pack
+    if (packSize > size || PACK_HEADER_SIZE + (size_t) count * PACK_ENTRY_SIZE > packSize)
+        return false;
+
+    pack.data = data;
+    pack.size = packSize;
+    pack.count = count;
+
+    //validate once, lookups can then trust the index
+    ImagePackEntry entry;
+    for (int i = 0; i < count; i++)
+    {
+        if (!GetImagePackEntry(pack, i, entry))
+        {
+            pack.data = NULL;
+            pack.size = 0;
+            pack.count = 0;
+            return false;
+        }
+    }
+
+    return true;
+}
+
+//Gets the index of an image by name, -1 if not in the pack
+int FindImagePackEntry(const ImagePack &pack, const char *name)
+{
+    for (int i = 0; i < pack.count; i++)
+    {
+        const char *entryName = (const char *) pack.data + PACK_HEADER_SIZE + i * PACK_ENTRY_SIZE;
+
+        if (strncmp(entryName, name, IMAGE_PACK_NAME) == 0 && strlen(name) <= IMAGE_PACK_NAME)
+            return i;
+    }
+
+    return -1;
+}
+
+//Gets an image of the pack by index
+bool GetImagePackEntry(const ImagePack &pack, int index, ImagePackEntry &entry)
+{
+    if (index < 0 || index >= pack.count)
+        return false;
+
+    const uint8_t *p = pack.data + PACK_HEADER_SIZE + index * PACK_ENTRY_SIZE;
+
+    memcpy(entry.name, p, IMAGE_PACK_NAME);
+    entry.name[IMAGE_PACK_NAME] = '\0';
+    entry.width = ReadPack16(p + 24);
+    entry.height = ReadPack16(p + 26);
+    entry.frames = ReadPack16(p + 28);
+
+    uint32_t durations = ReadPack32(p + 32);
+    uint32_t pixels = ReadPack32(p + 36);
+
+    //64-bit: a forged size must not wrap around a 32-bit size_t and pass the bounds check
+    uint64_t area = (uint64_t) entry.width * entry.height;
+    uint64_t length = area * 3 * entry.frames;
+
+    if (area == 0 || area > LED_IMAGE_MAX_PIXELS || entry.frames == 0 || pixels > pack.size || length > pack.size - pixels)
+        return false;
+
+    if (durations != 0 && (durations > pack.size || entry.frames * 2u > pack.size - durations))
+        return false;
+
+    entry.durations = (durations != 0) ? pack.data + durations : NULL;
+    entry.pixels = pack.data + pixels;
+
+    return true;
+}
+
+//Gets the RGB pixels of a frame
+const uint8_t *GetImagePackFrame(const ImagePackEntry &entry, int frame)
+{
+    //every frame of a validated entry lies inside the pack, so the offset fits a size_t
+    return entry.pixels + (size_t) ((uint64_t) (frame % entry.frames) * entry.width * entry.height * 3);
+}
+
+//Gets the duration of a frame in ms, 0 for stills
+uint16_t GetImagePackDuration(const ImagePackEntry &entry, int frame)
+{
+    if (entry.durations == NULL)
+        return 0;
+
+    return ReadPack16(entry.durations + (frame % entry.frames) * 2);
+}
+
+#ifdef ESP32
+//Maps the image pack partition into the address space (read only, no copy)
+bool MapImagePackPartition(ImagePack &pack)
+{
+    const esp_partition_t *partition = esp_partition_find_first(ESP_PARTITION_TYPE_DATA, ESP_PARTITION_SUBTYPE_ANY, IMAGE_PACK_PARTITION);
+    if (partition == NULL)
+        return false;
+
+    //the mapping stays for the lifetime of the firmware
+    const void *data = NULL;
+    spi_flash_mmap_handle_t handle;
+
+    if (esp_partition_mmap(partition, 0, partition->size, SPI_FLASH_MMAP_DATA, &data, &handle) != ESP_OK)
+        return false;
+
+    if (!OpenImagePack((const uint8_t *) data, partition->size, pack))
+    {
+        spi_flash_munmap(handle);
+        return false;
+    }
+
+    return true;
+}
+#else
+//Maps an image pack file (host)
+bool MapImagePackFile(const char *path, ImagePack &pack)
+{
+    int fd = open(path, O_RDONLY);
+    if (fd < 0)
+        return false;
+
+    struct stat info;
+    void *data = MAP_FAILED;
+
+    if (fstat(fd, &info) == 0 && info.st_size > 0)
+        data = mmap(NULL, info.st_size, PROT_READ, MAP_PRIVATE, fd, 0);
+
+    close(fd);
+
+    if (data == MAP_FAILED)
+        return false;
+
+    if (!OpenImagePack((const uint8_t *) data, info.st_size, pack))
+    {
+        munmap(data, info.st_size);
+        return false;
+    }
+
+    return true;
+}
+#endif
@@ -0,0 +1,540 @@
+//+--------------------------------------------------------------------------
+//
+// File:        ledanim.cpp
+//
+// Description: The purpose of this file is to provide playback of animated
+//              images stored on the filesystem. The file stays open and
+//              frames are decoded one at a time, a small chunk at a time,
+//              into a ring of frame buffers, so RAM use does not depend on
+//              the length of the animation. Delta-encoded animations only
+//              store the pixels that change between keyframes.
+//
+// History:     2026-10-18    PP Laplante   Created
+//
+//
+//---------------------------------------------------------------------------
+#include <Arduino.h>
+#include <SPIFFS.h>
+#include <FastLED.h>
+#include <traceutils.h>
+#include <logutils.h>
+#include <hexutils.h>
+#include <ledimage.h>
+#include <ledanim.h>
+
+static_assert(LED_ANIM_CHUNK % 6 == 0, "LED_ANIM_CHUNK must hold whole pixels");
+static_assert(LED_ANIM_BUFFERS >= 2, "LED_ANIM_BUFFERS must allow decoding ahead");
+static_assert(LED_ANIM_KEYFRAMES >= 2 && LED_ANIM_KEYFRAMES % 2 == 0, "LED_ANIM_KEYFRAMES must be even");
+
+#define LED_ANIM_HEADER_MAX         32          //longest "@A<w>,<h>,<n>;" header
+#define LED_ANIM_DURATION_CHARS     4           //frame duration, hexadecimal ms
+#define LED_ANIM_LENGTH_CHARS       6           //delta length, hexadecimal characters
+#define LED_ANIM_PAIR_CHARS         4           //delta skip/run pair
+#define LED_ANIM_DEFAULT_DURATION   100         //used for frames with a duration of 0
+
+struct LedAnimBuffer
+{
+    int         frame;                          //frame index held
+    uint16_t    duration;                       //display time in ms
+    CRGB        pixels[LED_ANIM_MAX_PIXELS];
+};
+
+struct LedAnimKeyframe
+{
+    int         frame;                          //frame index
+    size_t      offset;                         //offset of its record
+};
+
+//Global variables
+File ledAnimFile;                               //animation being played, kept open
+bool ledAnimOpen = false;                       //an animation is playing
+bool ledAnimDelta = false;                      //delta-encoded (variable size records)
+uint16_t ledAnimWidth = 0;                      //frame size
+uint16_t ledAnimHeight = 0;
+uint16_t ledAnimFrames = 0;                     //number of frames
+size_t ledAnimDataOffset = 0;                   //offset of the first frame record
+size_t ledAnimRecordSize = 0;                   //size of a frame record (not delta-encoded)
+
+char ledAnimChunk[LED_ANIM_CHUNK];              //file read buffer
+size_t ledAnimChunkOffset = 0;                  //file offset of the buffer start
+size_t ledAnimChunkLength = 0;                  //characters in the buffer
+size_t ledAnimChunkPos = 0;                     //read position in the buffer
+
+LedAnimKeyframe ledAnimKeyframes[LED_ANIM_KEYFRAMES];   //keyframes of a delta-encoded animation, every ledAnimKeyframeStride-th
+int ledAnimKeyframeCount = 0;
+int ledAnimKeyframeStride = 1;                  //keyframes of the file per entry of the table
+int ledAnimReadFrame = 0;                       //frame whose record is at the read position (delta-encoded)
+int ledAnimDecodedFrame = -1;                   //last frame decoded into the ring
+
+LedAnimBuffer ledAnimRing[LED_ANIM_BUFFERS];    //decoded frames, in display order from the head
+int ledAnimHead = 0;                            //buffer displayed
+int ledAnimCount = 0;                           //buffers holding frames, displayed one included
+bool ledAnimShown = false;                      //head frame drawn at least once
+unsigned long ledAnimShownAt = 0;               //time the head frame was drawn
+
+int ledAnimNextFrame = 0;                       //next frame to decode
+int ledAnimDirection = 1;                       //decoding direction (ping-pong)
+bool ledAnimEnded = false;                      //no frame left to decode
+
+bool ledAnimLoop = true;                        //start over after the last frame
+bool ledAnimPingPong = false;                   //play back and forth
+int ledAnimFps = 0;                             //frame rate override, 0 to use the file durations
+
+//Local Prototypes
+void SeekLEDAnimation(size_t offset);
+bool NeedLEDAnimationChars(size_t count);
+bool ReadLEDAnimationHex(size_t chars, uint32_t &value);
+bool ReadLEDAnimationPixels(CRGB *pixels, size_t count);
+bool ReadLEDAnimationHeader();
+bool ScanLEDAnimationRecords();
+bool ReadLEDAnimationRecord(LedAnimBuffer &buffer, const CRGB *previous);
+bool ReadLEDAnimationFrame(int frame, LedAnimBuffer &buffer, const LedAnimBuffer *previous);
+void AdvanceLEDAnimationCursor();
+
+//Gets whether a file of the image store is an animation
+bool IsLEDAnimationFile(String filePath)
+{
+    File file = SPIFFS.open(filePath);
+    if (!file)
+        return false;
+
+    char magic[2] = { 0, 0 };
+    file.read((uint8_t *) magic, sizeof(magic));
+    file.close();
+
+    return magic[0] == '@' && (magic[1] == 'A' || magic[1] == 'D');
+}
+
+//Moves the read position, keeping the buffer when the offset is in it
+void SeekLEDAnimation(size_t offset)
+{
+    if (offset >= ledAnimChunkOffset && offset <= ledAnimChunkOffset + ledAnimChunkLength)
+    {
+        ledAnimChunkPos = offset - ledAnimChunkOffset;
+        return;
+    }
+
+    ledAnimFile.seek(offset, SeekSet);
+    ledAnimChunkOffset = offset;
+    ledAnimChunkLength = 0;
+    ledAnimChunkPos = 0;
+}
+
+//Makes sure the next characters are in the buffer, contiguous (count at most LED_ANIM_CHUNK)
+bool NeedLEDAnimationChars(size_t count)
+{
+    size_t available = ledAnimChunkLength - ledAnimChunkPos;
+
+    if (available >= count)
+        return true;
+
+    //keep what is left at the start of the buffer, then fill it
+    memmove(ledAnimChunk, ledAnimChunk + ledAnimChunkPos, available);
+    ledAnimChunkOffset += ledAnimChunkPos;
+    ledAnimChunkPos = 0;
+    ledAnimChunkLength = available + ledAnimFile.read((uint8_t *) ledAnimChunk + available, LED_ANIM_CHUNK - available);
+
+    return ledAnimChunkLength >= count;
+}
+
+//Reads a big endian hexadecimal number (at most 8 characters, even count)
+bool ReadLEDAnimationHex(size_t chars, uint32_t &value)
+{
+    uint8_t bytes[4];
+
+    if (!NeedLEDAnimationChars(chars) || HexDecode(ledAnimChunk + ledAnimChunkPos, chars, bytes, sizeof(bytes)) != (int) chars / 2)
+        return false;
+
+    ledAnimChunkPos += chars;
+
+    value = 0;
+    for (size_t i = 0; i < chars / 2; i++)
+        value = (value << 8) | bytes[i];
+
+    return true;
+}
+
+//Decodes RRGGBB pixels, a buffer at a time
+bool ReadLEDAnimationPixels(CRGB *pixels, size_t count)
+{
+    while (count > 0)
+    {
+        size_t n = (count < LED_ANIM_CHUNK / 6) ? count : LED_ANIM_CHUNK / 6;
+
+        if (!NeedLEDAnimationChars(n * 6) || HexDecodePixels(ledAnimChunk + ledAnimChunkPos, n * 6, (uint8_t *) pixels, n) != (int) n)
+            return false;
+
+        ledAnimChunkPos += n * 6;
+        pixels += n;
+        count -= n;
+    }
+
+    return true;
+}
+
+//Parses "@A<width>,<height>,<frames>;" or "@D<width>,<height>,<frames>;"
+bool ReadLEDAnimationHeader()
+{
+    SeekLEDAnimation(0);
+    NeedLEDAnimationChars(LED_ANIM_HEADER_MAX);
+
+    const char *header = ledAnimChunk;
+    int length = ledAnimChunkLength;
+
+    if (length < 4 || header[0] != '@' || (header[1] != 'A' && header[1] != 'D'))
+        return false;
+
+    long values[3] = { 0, 0, 0 };
+    int v = 0;
+    int i = 2;
+
+    for (; i < length && v < 3; i++)
+    {
+        char c = header[i];
+
+        if (c >= '0' && c <= '9' && values[v] <= 0xFFFF)
+            values[v] = values[v] * 10 + (c - '0');
+        else if ((c == ',' && v < 2) || (c == ';' && v == 2))
+            v++;
+        else
+            return false;
+    }
+
+    //each side bounded first: values reach 655359, their product would overflow a 32-bit long
+    if (v < 3 || values[0] == 0 || values[1] == 0 || values[2] == 0 || values[0] > LED_ANIM_MAX_PIXELS || values[1] > LED_ANIM_MAX_PIXELS
+        || values[0] * values[1] > LED_ANIM_MAX_PIXELS || values[2] > 0xFFFF)
+        return false;
+
+    ledAnimDelta = (header[1] == 'D');
+    ledAnimWidth = values[0];
+    ledAnimHeight = values[1];
+    ledAnimFrames = values[2];
+
+    //a side truncated to 0 would give empty records that never advance through the file
+    if (ledAnimWidth == 0 || ledAnimHeight == 0 || ledAnimFrames == 0)
+        return false;
+
+    ledAnimDataOffset = i;
+    ledAnimRecordSize = LED_ANIM_DURATION_CHARS + (size_t) ledAnimWidth * ledAnimHeight * 6;
+
+    return true;
+}
+
+//Walks the records of a delta-encoded animation to check them and remember the keyframes
+bool ScanLEDAnimationRecords()
+{
+    TRACE_SCOPE("ScanLEDAnimationRecords");
+
+    size_t offset = ledAnimDataOffset;
+    int keyframes = 0;
+    ledAnimKeyframeCount = 0;
+    ledAnimKeyframeStride = 1;
+
+    for (int frame = 0; frame < ledAnimFrames; frame++)
+    {
+        SeekLEDAnimation(offset);
+
+        if (!NeedLEDAnimationChars(1 + LED_ANIM_DURATION_CHARS))
+            return false;
+
+        char type = ledAnimChunk[ledAnimChunkPos];
+        size_t length = 0;
+
+        if (type == 'K')
+        {
+            //table full: keep every other entry and record half as often, so the entries stay spread over the whole file
+            if (keyframes % ledAnimKeyframeStride == 0 && ledAnimKeyframeCount == LED_ANIM_KEYFRAMES)
+            {
+                for (int k = 0; k < LED_ANIM_KEYFRAMES / 2; k++)
+                    ledAnimKeyframes[k] = ledAnimKeyframes[k * 2];
+
+                ledAnimKeyframeCount = LED_ANIM_KEYFRAMES / 2;
+                ledAnimKeyframeStride *= 2;
+            }
+
+            if (keyframes % ledAnimKeyframeStride == 0)
+                ledAnimKeyframes[ledAnimKeyframeCount++] = { frame, offset };
+
+            keyframes++;
+            length = (size_t) ledAnimWidth * ledAnimHeight * 6;
+        }
+        else if (type == 'D' && frame > 0)
+        {
+            uint32_t value = 0;
+
+            ledAnimChunkPos += 1 + LED_ANIM_DURATION_CHARS;
+            if (!ReadLEDAnimationHex(LED_ANIM_LENGTH_CHARS, value))
+                return false;
+
+            length = LED_ANIM_LENGTH_CHARS + value;
+        }
+        else
+            return false;
+
+        offset += 1 + LED_ANIM_DURATION_CHARS + length;
+    }
+
+    return ledAnimFile.size() >= offset;
+}
+
+//Opens an animation, returns false if not valid
+bool StartLEDAnimation(String filePath)
+{
+    TRACE_SCOPE("StartLEDAnimation");
+
+    StopLEDAnimation();
+
+    ledAnimFile = SPIFFS.open(filePath);
+    if (!ledAnimFile)
+    {
+        LOG_WARN("Unable to open animation %s", filePath.c_str());
+        return false;
+    }
+
+    ledAnimChunkOffset = 0;
+    ledAnimChunkLength = 0;
+    ledAnimChunkPos = 0;
+
+    bool valid = ReadLEDAnimationHeader();
+    if (valid && ledAnimDelta)
+        valid = ScanLEDAnimationRecords();
+    else if (valid)
+        valid = ledAnimFile.size() >= ledAnimDataOffset + ledAnimFrames * ledAnimRecordSize;
+
+    if (!valid)
+    {
+        LOG_WARN("Invalid animation %s (at most %d pixels per frame)", filePath.c_str(), LED_ANIM_MAX_PIXELS);
+        ledAnimFile.close();
+        return false;
+    }
+
+    ledAnimOpen = true;
+    ledAnimHead = 0;
+    ledAnimCount = 0;
+    ledAnimShown = false;
+    ledAnimNextFrame = 0;
+    ledAnimDirection = 1;
+    ledAnimEnded = false;
+    ledAnimReadFrame = 0;
+    ledAnimDecodedFrame = -1;
+    SeekLEDAnimation(ledAnimDataOffset);
+
+    LOG_DEBUG("Animation %s: %dx%d, %d frames%s", filePath.c_str(), ledAnimWidth, ledAnimHeight, ledAnimFrames, ledAnimDelta ? " (delta)" : "");
+
+    return true;
+}
+
+//Closes the animation file
+void StopLEDAnimation()
+{
+    if (ledAnimOpen)
+        ledAnimFile.close();
+
+    ledAnimOpen = false;
+}
+
+//Decodes the delta-encoded record at the read position, applied over the previous frame
+bool ReadLEDAnimationRecord(LedAnimBuffer &buffer, const CRGB *previous)
+{
+    size_t count = (size_t) ledAnimWidth * ledAnimHeight;
+    uint32_t value = 0;
+
+    if (!NeedLEDAnimationChars(1))
+        return false;
+
+    char type = ledAnimChunk[ledAnimChunkPos++];
+
+    if (!ReadLEDAnimationHex(LED_ANIM_DURATION_CHARS, value))
+        return false;
+
+    buffer.duration = value;
+
+    if (type == 'K')
+        return ReadLEDAnimationPixels(buffer.pixels, count);
+
+    //delta: unchanged pixels come from the previous frame
+    if (type != 'D' || previous == NULL || !ReadLEDAnimationHex(LED_ANIM_LENGTH_CHARS, value))
+        return false;
+
+    if (previous != buffer.pixels)
+        memcpy(buffer.pixels, previous, count * sizeof(CRGB));
+
+    size_t end = ledAnimChunkOffset + ledAnimChunkPos + value;
+    size_t index = 0;
+
+    while (ledAnimChunkOffset + ledAnimChunkPos < end)
+    {
+        uint32_t pair = 0;
+
+        if (!ReadLEDAnimationHex(LED_ANIM_PAIR_CHARS, pair))
+            return false;
+
+        index += pair >> 8;
+        size_t run = pair & 0xFF;
+
+        if (index + run > count || !ReadLEDAnimationPixels(&buffer.pixels[index], run))
+            return false;
+
+        index += run;
+    }
+
+    return ledAnimChunkOffset + ledAnimChunkPos == end;
+}
+
+//Decodes a frame into a ring buffer, previous holding the frame decoded before it if any
+bool ReadLEDAnimationFrame(int frame, LedAnimBuffer &buffer, const LedAnimBuffer *previous)
+{
+    TRACE_SCOPE("ReadLEDAnimationFrame");
+
+    buffer.frame = frame;
+
+    if (!ledAnimDelta)
+    {
+        //fixed size records, read directly
+        uint32_t duration = 0;
+
+        SeekLEDAnimation(ledAnimDataOffset + frame * ledAnimRecordSize);
+        if (!ReadLEDAnimationHex(LED_ANIM_DURATION_CHARS, duration)
+            || !ReadLEDAnimationPixels(buffer.pixels, (size_t) ledAnimWidth * ledAnimHeight))
+            return false;
+
+        buffer.duration = duration;
+    }
+    else if (previous != NULL && previous->frame == frame - 1 && ledAnimReadFrame == frame)
+    {
+        //next in the file: apply the delta to a copy of the previous frame
+        if (!ReadLEDAnimationRecord(buffer, previous->pixels))
+            return false;
+
+        ledAnimReadFrame++;
+    }
+    else
+    {
+        //restart or backwards: replay from the closest keyframe recorded, in place (up to
+        //ledAnimKeyframeStride keyframe intervals of records when the file has more than the table)
+        int k = 0;
+        while (k + 1 < ledAnimKeyframeCount && ledAnimKeyframes[k + 1].frame <= frame)
+            k++;
+
+        SeekLEDAnimation(ledAnimKeyframes[k].offset);
+
+        for (ledAnimReadFrame = ledAnimKeyframes[k].frame; ledAnimReadFrame <= frame; ledAnimReadFrame++)
+            if (!ReadLEDAnimationRecord(buffer, buffer.pixels))
+                return false;
+    }
+
+    if (buffer.duration == 0)
+        buffer.duration = LED_ANIM_DEFAULT_DURATION;
+
+    return true;
+}
+
+//Moves the decoding cursor to the frame following the one just decoded
+void AdvanceLEDAnimationCursor()
+{
+    int frame = ledAnimNextFrame;
+
+    if (ledAnimFrames == 1)
+    {
+        ledAnimEnded = !ledAnimLoop;
+        return;
+    }
+
+    if (ledAnimPingPong)
+    {
+        int next = frame + ledAnimDirection;
+
+        if (next < 0 || next >= ledAnimFrames)
+        {
+            //back at the first frame: one full cycle done
+            if (next < 0 && !ledAnimLoop)
+            {
+                ledAnimEnded = true;
+                return;
+            }
+
+            ledAnimDirection = -ledAnimDirection;
+            next = frame + ledAnimDirection;
+        }
+
+        ledAnimNextFrame = next;
+    }
+    else if (frame + 1 < ledAnimFrames)
+        ledAnimNextFrame = frame + 1;
+    else if (ledAnimLoop)
+        ledAnimNextFrame = 0;
+    else
+        ledAnimEnded = true;
+}
+
+//Draws the next frame onto the matrix when it is due, returns true if the LEDs changed
+bool UpdateLEDAnimation(unsigned long now, CRGB *target, LedImageMode mode)
+{
+    if (!ledAnimOpen)
+        return false;
+
+    bool drawn = false;
+
+    //first frame, or the head frame has been displayed long enough and the next one is ready
+    if (ledAnimCount > 0)
+    {
+        unsigned long duration = (ledAnimFps > 0) ? 1000 / ledAnimFps : ledAnimRing[ledAnimHead].duration;
+        bool due = !ledAnimShown || (ledAnimCount > 1 && now - ledAnimShownAt >= duration);
+
+        if (due)
+        {
+            if (ledAnimShown)
+            {
+                ledAnimHead = (ledAnimHead + 1) % LED_ANIM_BUFFERS;
+                ledAnimCount--;
+            }
+
+            LedImage frame = { ledAnimWidth, ledAnimHeight, ledAnimRing[ledAnimHead].pixels };
+            BlitLEDImage(frame, target, mode);
+
+            ledAnimShown = true;
+            ledAnimShownAt = now;
+            drawn = true;
+        }
+    }
+
+    //decode at most one frame ahead per call
+    if (ledAnimCount < LED_ANIM_BUFFERS && !ledAnimEnded)
+    {
+        int slot = (ledAnimHead + ledAnimCount) % LED_ANIM_BUFFERS;
+        int last = (slot + LED_ANIM_BUFFERS - 1) % LED_ANIM_BUFFERS;
+        const LedAnimBuffer *previous = (ledAnimDecodedFrame >= 0) ? &ledAnimRing[last] : NULL;
+
+        if (ReadLEDAnimationFrame(ledAnimNextFrame, ledAnimRing[slot], previous))
+        {
+            ledAnimDecodedFrame = ledAnimNextFrame;
+            ledAnimCount++;
+            AdvanceLEDAnimationCursor();
+        }
+        else
+        {
+            LOG_WARN("Invalid animation frame %d", ledAnimNextFrame);
+            ledAnimEnded = true;
+        }
+    }
+
+    return drawn;
+}
+
+//Sets whether the animation starts over after its last frame
+void SetLEDAnimationLoop(bool loop)
+{
+    ledAnimLoop = loop;
+}
+
+//Sets whether the animation plays back and forth instead of starting over
+void SetLEDAnimationPingPong(bool pingpong)
+{
+    ledAnimPingPong = pingpong;
+}
+
+//Sets a frame rate overriding the durations of the file, 0 to use the file durations
+void SetLEDAnimationFps(int fps)
+{
+    ledAnimFps = (fps < 0) ? 0 : fps;
+}
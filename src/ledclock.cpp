@@ -0,0 +1,116 @@
+//+--------------------------------------------------------------------------
+//
+// File:        ledclock.cpp
+//
+// Description: The purpose of this file is to provide a clock drawn on its
+//              own overlay layer, over whatever effect is displayed. The
+//              layer is only redrawn when the displayed minute (or second)
+//              changes.
+//
+// History:     2026-10-18    PP Laplante   Created
+//
+//
+//---------------------------------------------------------------------------
+#include <Arduino.h>
+#include <FastLED.h>
+#include <ledconfig.h>
+#include <ledfont.h>
+#include <ledlayers.h>
+#include <ledclock.h>
+
+//"HH:MM" on one line needs 19 columns, narrower matrices stack hours over minutes
+#define LED_CLOCK_ONE_LINE      (LED_MATRIX_WIDTH >= 5*LED_FONT_WIDTH + 4)
+
+//Global variables
+bool ledClockEnabled = false;                   //clock overlay shown
+bool ledClockSeconds = false;                   //seconds bar shown
+CRGB ledClockColor = CRGB(255, 255, 255);       //digit colour
+long ledClockDisplayed = -1;                    //time currently drawn, -1 to force a redraw
+
+//Local Prototypes
+void DrawLEDClockText(const char *text, int x, int y);
+
+//Shows or hides the clock overlay
+void SetLEDClockEnabled(bool enabled)
+{
+    ledClockEnabled = enabled;
+    ledClockDisplayed = -1;
+
+    if (!enabled)
+        ClearLEDLayer(LED_LAYER_CLOCK);
+}
+
+//Gets whether the clock overlay is shown
+bool GetLEDClockEnabled()
+{
+    return ledClockEnabled;
+}
+
+//Sets the colour of the clock digits
+void SetLEDClockColor(CRGB color)
+{
+    ledClockColor = color;
+    ledClockDisplayed = -1;
+}
+
+//Sets whether the seconds are shown (as a bar on the bottom row)
+void SetLEDClockSeconds(bool seconds)
+{
+    ledClockSeconds = seconds;
+    ledClockDisplayed = -1;
+}
+
+//Draws text on the clock layer, one column between glyphs
+void DrawLEDClockText(const char *text, int x, int y)
+{
+    for (; *text != '\0'; text++, x += LED_FONT_WIDTH + 1)
+    {
+        const uint8_t *glyph = GetLEDFontGlyph(*text);
+        if (glyph == NULL)
+            continue;
+
+        for (int row = 0; row < LED_FONT_HEIGHT; row++)
+            for (int col = 0; col < LED_FONT_WIDTH; col++)
+                if (GetLEDFontPixel(glyph, col, row))
+                    SetLEDLayerPixel(LED_LAYER_CLOCK, x + col, y + row, ledClockColor);
+    }
+}
+
+//Redraws the clock overlay if the displayed time changed - to be added to the main loop
+void UpdateLEDClock(int hours, int minutes, int seconds)
+{
+    if (!ledClockEnabled)
+        return;
+
+    //what is displayed only depends on these
+    long displayed = hours * 60L + minutes;
+    if (ledClockSeconds)
+        displayed = displayed * 60L + seconds;
+
+    if (displayed == ledClockDisplayed)
+        return;
+    ledClockDisplayed = displayed;
+
+    char hh[3] = { (char) ('0' + hours / 10), (char) ('0' + hours % 10), '\0' };
+    char mm[3] = { (char) ('0' + minutes / 10), (char) ('0' + minutes % 10), '\0' };
+    int textWidth = 2*LED_FONT_WIDTH + 1;
+
+    ClearLEDLayer(LED_LAYER_CLOCK);
+
+    #if LED_CLOCK_ONE_LINE
+        int x = (LED_MATRIX_WIDTH - (2*textWidth + LED_FONT_WIDTH + 2)) / 2;
+        int y = (LED_MATRIX_HEIGHT - LED_FONT_HEIGHT) / 2;
+        DrawLEDClockText(hh, x, y);
+        DrawLEDClockText(":", x + textWidth + 1, y);
+        DrawLEDClockText(mm, x + textWidth + LED_FONT_WIDTH + 2, y);
+    #else
+        int x = (LED_MATRIX_WIDTH - textWidth) / 2;
+        int y = (LED_MATRIX_HEIGHT - (2*LED_FONT_HEIGHT + 2)) / 2;
+        DrawLEDClockText(hh, x, y);
+        DrawLEDClockText(mm, x, y + LED_FONT_HEIGHT + 2);
+    #endif
+
+    //seconds as a growing bar on the bottom row
+    if (ledClockSeconds)
+        FillLEDLayerRect(LED_LAYER_CLOCK, 0, LED_MATRIX_HEIGHT - 1, (seconds + 1) * LED_MATRIX_WIDTH / 60, 1, ledClockColor, 128);
+}
@@ -0,0 +1,101 @@
+//+--------------------------------------------------------------------------
+//
+// File:        ledfont.cpp
+//
+// Description: The purpose of this file is to provide a tiny 3x5 bitmap
+//              font kept in flash (printable ASCII, upper case only),
+//              small enough to fit four digits on a 16 pixels wide matrix.
+//
+// History:     2026-10-18    PP Laplante   Created
+//
+//
+//---------------------------------------------------------------------------
+#include <Arduino.h>
+#include <ledfont.h>
+
+#define B(r)    (0b##r)
+
+//' ' to 'Z', lower case letters use the upper case glyphs
+#define LED_FONT_FIRST          ' '
+#define LED_FONT_LAST           'Z'
+
+const uint8_t ledFont[LED_FONT_LAST - LED_FONT_FIRST + 1][LED_FONT_HEIGHT] PROGMEM =
+{
+    { B(000), B(000), B(000), B(000), B(000) },     //space
+    { B(010), B(010), B(010), B(000), B(010) },     //!
+    { B(101), B(101), B(000), B(000), B(000) },     //"
+    { B(101), B(111), B(101), B(111), B(101) },     //#
+    { B(011), B(110), B(010), B(011), B(110) },     //$
+    { B(101), B(001), B(010), B(100), B(101) },     //%
+    { B(010), B(101), B(010), B(101), B(011) },     //&
+    { B(010), B(010), B(000), B(000), B(000) },     //'
+    { B(001), B(010), B(010), B(010), B(001) },     //(
+    { B(100), B(010), B(010), B(010), B(100) },     //)
+    { B(000), B(101), B(010), B(101), B(000) },     //*
+    { B(000), B(010), B(111), B(010), B(000) },     //+
+    { B(000), B(000), B(000), B(010), B(100) },     //,
+    { B(000), B(000), B(111), B(000), B(000) },     //-
+    { B(000), B(000), B(000), B(000), B(010) },     //.
+    { B(001), B(001), B(010), B(100), B(100) },     ///
+    { B(111), B(101), B(101), B(101), B(111) },     //0
+    { B(010), B(110), B(010), B(010), B(111) },     //1
+    { B(111), B(001), B(111), B(100), B(111) },     //2
+    { B(111), B(001), B(011), B(001), B(111) },     //3
+    { B(101), B(101), B(111), B(001), B(001) },     //4
+    { B(111), B(100), B(111), B(001), B(111) },     //5
+    { B(111), B(100), B(111), B(101), B(111) },     //6
+    { B(111), B(001), B(010), B(010), B(010) },     //7
+    { B(111), B(101), B(111), B(101), B(111) },     //8
+    { B(111), B(101), B(111), B(001), B(111) },     //9
+    { B(000), B(010), B(000), B(010), B(000) },     //:
+    { B(000), B(010), B(000), B(010), B(100) },     //;
+    { B(001), B(010), B(100), B(010), B(001) },     //<
+    { B(000), B(111), B(000), B(111), B(000) },     //=
+    { B(100), B(010), B(001), B(010), B(100) },     //>
+    { B(111), B(001), B(010), B(000), B(010) },     //?
+    { B(010), B(101), B(111), B(100), B(011) },     //@
+    { B(010), B(101), B(111), B(101), B(101) },     //A
+    { B(110), B(101), B(110), B(101), B(110) },     //B
+    { B(011), B(100), B(100), B(100), B(011) },     //C
+    { B(110), B(101), B(101), B(101), B(110) },     //D
+    { B(111), B(100), B(110), B(100), B(111) },     //E
+    { B(111), B(100), B(110), B(100), B(100) },     //F
+    { B(011), B(100), B(101), B(101), B(011) },     //G
+    { B(101), B(101), B(111), B(101), B(101) },     //H
+    { B(111), B(010), B(010), B(010), B(111) },     //I
+    { B(001), B(001), B(001), B(101), B(010) },     //J
+    { B(101), B(101), B(110), B(101), B(101) },     //K
+    { B(100), B(100), B(100), B(100), B(111) },     //L
+    { B(101), B(111), B(111), B(101), B(101) },     //M
+    { B(110), B(101), B(101), B(101), B(101) },     //N
+    { B(010), B(101), B(101), B(101), B(010) },     //O
+    { B(110), B(101), B(110), B(100), B(100) },     //P
+    { B(010), B(101), B(101), B(110), B(011) },     //Q
+    { B(110), B(101), B(110), B(101), B(101) },     //R
+    { B(011), B(100), B(010), B(001), B(110) },     //S
+    { B(111), B(010), B(010), B(010), B(010) },     //T
+    { B(101), B(101), B(101), B(101), B(111) },     //U
+    { B(101), B(101), B(101), B(101), B(010) },     //V
+    { B(101), B(101), B(111), B(111), B(101) },     //W
+    { B(101), B(101), B(010), B(101), B(101) },     //X
+    { B(101), B(101), B(010), B(010), B(010) },     //Y
+    { B(111), B(001), B(010), B(100), B(111) },     //Z
+};
+
+//Gets the rows of a glyph, top first, bit 2 being the leftmost column
+const uint8_t *GetLEDFontGlyph(char c)
+{
+    if (c >= 'a' && c <= 'z')
+        c -= 'a' - 'A';
+
+    if (c < LED_FONT_FIRST || c > LED_FONT_LAST)
+        return NULL;
+
+    return ledFont[c - LED_FONT_FIRST];
+}
+
+//Gets whether a glyph pixel is lit
+bool GetLEDFontPixel(const uint8_t *glyph, int x, int y)
+{
+    return (pgm_read_byte(&glyph[y]) >> (LED_FONT_WIDTH - 1 - x)) & 1;
+}
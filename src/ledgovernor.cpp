@@ -0,0 +1,87 @@
+//+--------------------------------------------------------------------------
+//
+// File:        ledgovernor.cpp
+//
+// Description: The purpose of this file is to provide the frame rate
+//              governor: the cost of every frame is averaged per effect and
+//              the frame period is stretched when the effect needs more than
+//              its share of it, so an overloaded installation drops frames
+//              evenly instead of starving WiFi and the web server. The
+//              period recovers step by step once there is headroom again.
+//
+// History:     2026-10-18    PP Laplante   Created
+//
+//
+//---------------------------------------------------------------------------
+#include <Arduino.h>
+#include <logutils.h>
+#include <ledgovernor.h>
+
+//Global variables
+unsigned long ledGovernorAverage = 0;           //frame cost, exponential moving average (us, 4 fractional bits)
+long ledGovernorPeriod = 0;                     //frame period chosen (ms), 0 until the first frame
+unsigned long ledGovernorOverruns = 0;          //frames longer than the requested period
+
+//Forgets the measurements, the next effect starts at its requested framerate
+void ResetLEDGovernor()
+{
+    ledGovernorAverage = 0;
+    ledGovernorPeriod = 0;
+    ledGovernorOverruns = 0;
+}
+
+//Records the cost of a frame in us, returns the frame period to use in ms (at least the requested one)
+long UpdateLEDGovernor(unsigned long frameTime, long requestedPeriod)
+{
+    if (frameTime > (unsigned long) requestedPeriod * 1000)
+        ledGovernorOverruns++;
+
+    //weight 1/8: a single slow frame (WiFi, flash access) does not move it much
+    if (ledGovernorAverage == 0)
+        ledGovernorAverage = frameTime << 4;
+    else
+        ledGovernorAverage = ledGovernorAverage - (ledGovernorAverage >> 3) + (frameTime << 1);
+
+    if (ledGovernorPeriod < requestedPeriod)
+        ledGovernorPeriod = requestedPeriod;
+
+    #if LED_GOVERNOR_ENABLED
+        unsigned long cost = ledGovernorAverage >> 4;
+
+        if (cost > (unsigned long) ledGovernorPeriod * 10 * LED_GOVERNOR_LOAD)
+        {
+            //over budget: stretch the period at once so the frame fits
+            long period = (cost * 100 / LED_GOVERNOR_LOAD + 999) / 1000;
+
+            LOG_DEBUG("Frame cost %luus, period %ldms -> %ldms", cost, ledGovernorPeriod, period);
+            ledGovernorPeriod = period;
+        }
+        else if (ledGovernorPeriod > requestedPeriod && cost < (unsigned long) ledGovernorPeriod * 10 * LED_GOVERNOR_RECOVER)
+        {
+            //headroom again: an eighth closer to the requested period per frame
+            ledGovernorPeriod -= max(1L, (ledGovernorPeriod - requestedPeriod) >> 3);
+        }
+    #else
+        ledGovernorPeriod = requestedPeriod;
+    #endif
+
+    return ledGovernorPeriod;
+}
+
+//Gets the frame period chosen in ms
+long GetLEDGovernorPeriod()
+{
+    return ledGovernorPeriod;
+}
+
+//Gets the average frame cost of the current effect in us
+unsigned long GetLEDGovernorFrameTime()
+{
+    return ledGovernorAverage >> 4;
+}
+
+//Gets how many frames of the current effect took longer than the requested period
+unsigned long GetLEDGovernorOverruns()
+{
+    return ledGovernorOverruns;
+}
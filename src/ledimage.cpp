@@ -0,0 +1,591 @@
+//+--------------------------------------------------------------------------
+//
+// File:        ledimage.cpp
+//
+// Description: The purpose of this file is to provide decoding of stored
+//              images and drawing them onto the configured matrix whatever
+//              their own size: stretched (nearest or bilinear), centred or
+//              tiled. Scaling uses 16.16 fixed point, no floating point.
+//              Images using few colours are stored as a palette plus
+//              indices, optionally run-length encoded.
+//
+// History:     2026-10-18    PP Laplante   Created
+//
+//
+//---------------------------------------------------------------------------
+#include <Arduino.h>
+#include <FastLED.h>
+#include <hexutils.h>
+#include <ledconfig.h>
+#include <ledmatrix.h>
+#include <ledimage.h>
+
+#define FIXED_HALF      0x8000          //0.5 in 16.16 fixed point
+#define IMAGE_BLOCK     64              //bytes of indices or runs decoded at once
+#define IMAGE_PALETTE   256             //largest palette
+
+const char *ledImageModeNames[] = { "nearest", "bilinear", "center", "tile" };
+
+//Local Prototypes
+bool ParseLEDImageHeader(const char *data, size_t length, int *values, int count, size_t &headerLength);
+bool DecodeLEDImageIndexed(const char *data, size_t length, LedImage &image, int colors, bool runs, int *errorPos);
+bool CanOmitLEDImageHeader(const LedImage &image);
+int BuildLEDImagePalette(const LedImage &image, CRGB *palette, uint8_t *indices);
+char *WriteLEDImageHex(char *out, const uint8_t *bytes, size_t count);
+void BlitLEDImageNearest(const LedImage &image, CRGB *target);
+void BlitLEDImageBilinear(const LedImage &image, CRGB *target);
+void BlitLEDImageOffset(const LedImage &image, CRGB *target, bool tile);
+
+//Reads a "@<type><value>,<value>...;" header (count values), returns false if malformed
+bool ParseLEDImageHeader(const char *data, size_t length, int *values, int count, size_t &headerLength)
+{
+    int v = 0;
+    size_t i = 2;
+
+    for (int n = 0; n < count; n++)
+        values[n] = 0;
+
+    for (; i < length && v < count; i++)
+    {
+        char c = data[i];
+
+        //sizes above 0xFFFF are rejected before they can overflow
+        if (c >= '0' && c <= '9' && values[v] <= 0xFFFF)
+            values[v] = values[v] * 10 + (c - '0');
+        else if ((c == ',' && v < count - 1) || (c == ';' && v == count - 1))
+            v++;
+        else
+            break;
+    }
+
+    headerLength = i;
+
+    return v == count;
+}
+
+//Decodes palette indices ("@P") or runs of indices ("@R") following the palette
+bool DecodeLEDImageIndexed(const char *data, size_t length, LedImage &image, int colors, bool runs, int *errorPos)
+{
+    CRGB palette[IMAGE_PALETTE];
+    size_t count = (size_t) image.width * image.height;
+    size_t paletteLength = (size_t) colors * 6;
+
+    if (length < paletteLength || HexDecodePixels(data, paletteLength, (uint8_t *) palette, colors, errorPos) != colors)
+    {
+        if (errorPos != NULL && length < paletteLength)
+            *errorPos = length;
+        return false;
+    }
+
+    //bytes are decoded a block at a time, then looked up straight into the pixels
+    uint8_t block[IMAGE_BLOCK];
+    bool nibbles = !runs && colors <= 16;
+    size_t pos = paletteLength;
+    size_t pixel = 0;
+
+    while (pos < length)
+    {
+        size_t chars = length - pos;
+        if (chars > IMAGE_BLOCK * 2)
+            chars = IMAGE_BLOCK * 2;
+
+        int bytes = HexDecode(data + pos, chars, block, sizeof(block), errorPos);
+        if (bytes < 0)
+        {
+            if (errorPos != NULL)
+                *errorPos += pos;
+            return false;
+        }
+
+        for (int b = 0; b < bytes; b++)
+        {
+            int at = b;
+            bool valid;
+
+            if (runs)
+            {
+                //(length - 1, index) pairs, blocks hold whole pairs
+                size_t run = block[b] + 1;
+                valid = b + 1 < bytes && block[b + 1] < colors && pixel + run <= count;
+
+                for (size_t r = 0; valid && r < run; r++)
+                    image.pixels[pixel++] = palette[block[b + 1]];
+                b++;
+            }
+            else if (nibbles)
+            {
+                //two pixels per byte, first one in the high nibble, the last low nibble may be padding
+                uint8_t high = block[b] >> 4;
+                uint8_t low = block[b] & 0x0F;
+                valid = pixel < count && high < colors && (pixel + 1 == count || low < colors);
+
+                if (valid)
+                {
+                    image.pixels[pixel++] = palette[high];
+                    if (pixel < count)
+                        image.pixels[pixel++] = palette[low];
+                }
+            }
+            else
+            {
+                valid = pixel < count && block[b] < colors;
+
+                if (valid)
+                    image.pixels[pixel++] = palette[block[b]];
+            }
+
+            if (!valid)
+            {
+                if (errorPos != NULL)
+                    *errorPos = pos + at * 2;
+                return false;
+            }
+        }
+
+        pos += chars;
+    }
+
+    if (pixel != count)
+    {
+        if (errorPos != NULL)
+            *errorPos = length;
+        return false;
+    }
+
+    return true;
+}
+
+//Decodes image data into image.pixels (capacity in pixels)
+bool DecodeLEDImage(const char *data, size_t length, LedImage &image, size_t capacity, int *errorPos)
+{
+    int values[3] = { 0, 0, 0 };
+    size_t headerLength = 0;
+
+    //palette images: size and palette in the header, decoded in a single pass
+    if (length >= 2 && data[0] == '@' && (data[1] == 'P' || data[1] == 'R'))
+    {
+        if (!ParseLEDImageHeader(data, length, values, 3, headerLength) || values[0] == 0 || values[1] == 0
+            || values[2] == 0 || values[2] > IMAGE_PALETTE || values[0] > 0xFFFF || values[1] > 0xFFFF
+            || (uint64_t) values[0] * values[1] > capacity)
+        {
+            if (errorPos != NULL)
+                *errorPos = headerLength;
+            return false;
+        }
+
+        image.width = values[0];
+        image.height = values[1];
+
+        if (!DecodeLEDImageIndexed(data + headerLength, length - headerLength, image, values[2], data[1] == 'R', errorPos))
+        {
+            if (errorPos != NULL)
+                *errorPos += headerLength;
+            return false;
+        }
+
+        return true;
+    }
+
+    //optional size header
+    if (length >= 2 && data[0] == '@' && data[1] == 'I')
+    {
+        if (!ParseLEDImageHeader(data, length, values, 2, headerLength))
+        {
+            if (errorPos != NULL)
+                *errorPos = headerLength;
+            return false;
+        }
+    }
+
+    int width = values[0];
+    int height = values[1];
+    int count = HexDecodePixels(data + headerLength, length - headerLength, (uint8_t *) image.pixels, capacity, errorPos);
+
+    if (count < 0)
+    {
+        if (errorPos != NULL)
+            *errorPos += headerLength;
+        return false;
+    }
+
+    if (headerLength == 0)
+    {
+        //no header: square image, or as wide as the matrix
+        int side = 0;
+        while ((side + 1) * (side + 1) <= count)
+            side++;
+
+        if (side * side == count)
+            width = height = side;
+        else if (count % LED_MATRIX_WIDTH == 0)
+        {
+            width = LED_MATRIX_WIDTH;
+            height = count / LED_MATRIX_WIDTH;
+        }
+    }
+
+    if (width <= 0 || height <= 0 || width > count || height > count || width * height != count)
+    {
+        if (errorPos != NULL)
+            *errorPos = length;
+        return false;
+    }
+
+    image.width = width;
+    image.height = height;
+
+    return true;
+}
+
+//Gets whether an image decodes to the same size without a "@I" header
+bool CanOmitLEDImageHeader(const LedImage &image)
+{
+    int count = image.width * image.height;
+    int side = 0;
+
+    while ((side + 1) * (side + 1) <= count)
+        side++;
+
+    //headerless images are square when they can be
+    if (side * side == count)
+        return image.width == side;
+
+    return image.width == LED_MATRIX_WIDTH;
+}
+
+//Builds the palette of an image and the palette index of each pixel
+//  returns the number of colours, or -1 if there are more than the largest palette
+int BuildLEDImagePalette(const LedImage &image, CRGB *palette, uint8_t *indices)
+{
+    size_t count = (size_t) image.width * image.height;
+    int colors = 0;
+    int last = 0;
+
+    for (size_t i = 0; i < count; i++)
+    {
+        const CRGB &color = image.pixels[i];
+
+        //neighbours mostly share their colour, look further only when it changes
+        if (colors == 0 || palette[last] != color)
+        {
+            last = 0;
+            while (last < colors && palette[last] != color)
+                last++;
+
+            if (last == colors)
+            {
+                if (colors == IMAGE_PALETTE)
+                    return -1;
+
+                palette[colors++] = color;
+            }
+        }
+
+        indices[i] = last;
+    }
+
+    return colors;
+}
+
+//Writes bytes as uppercase hexadecimal, returns the end of the text
+char *WriteLEDImageHex(char *out, const uint8_t *bytes, size_t count)
+{
+    static const char digits[] = "0123456789ABCDEF";
+
+    for (size_t i = 0; i < count; i++)
+    {
+        *out++ = digits[bytes[i] >> 4];
+        *out++ = digits[bytes[i] & 0x0F];
+    }
+
+    return out;
+}
+
+//Encodes an image in the smallest of the stored representations
+String EncodeLEDImage(const LedImage &image)
+{
+    size_t count = (size_t) image.width * image.height;
+    CRGB palette[IMAGE_PALETTE];
+    uint8_t *indices = (uint8_t *) malloc(count);
+
+    if (indices == NULL)
+        return "";
+
+    int colors = BuildLEDImagePalette(image, palette, indices);
+
+    //number of runs of the same colour (at most 256 pixels each)
+    size_t runs = 0;
+    for (size_t i = 0; colors > 0 && i < count; runs++)
+    {
+        size_t run = 1;
+        while (i + run < count && run < 256 && indices[i + run] == indices[i])
+            run++;
+        i += run;
+    }
+
+    //length of each representation, header included
+    char headers[3][32];
+    size_t lengths[3];
+    int chosen = 0;
+
+    lengths[0] = snprintf(headers[0], sizeof(headers[0]), CanOmitLEDImageHeader(image) ? "" : "@I%u,%u;", image.width, image.height) + count * 6;
+
+    if (colors > 0)
+    {
+        lengths[1] = snprintf(headers[1], sizeof(headers[1]), "@P%u,%u,%d;", image.width, image.height, colors) + colors * 6
+            + ((colors <= 16) ? (count + 1) / 2 * 2 : count * 2);
+        lengths[2] = snprintf(headers[2], sizeof(headers[2]), "@R%u,%u,%d;", image.width, image.height, colors) + colors * 6 + runs * 4;
+
+        for (int i = 1; i < 3; i++)
+            if (lengths[i] < lengths[chosen])
+                chosen = i;
+    }
+
+    char *text = (char *) malloc(lengths[chosen] + 1);
+    if (text == NULL)
+    {
+        free(indices);
+        return "";
+    }
+
+    char *out = text + strlen(headers[chosen]);
+    memcpy(text, headers[chosen], out - text);
+
+    if (chosen == 0)
+        out = WriteLEDImageHex(out, (const uint8_t *) image.pixels, count * 3);
+    else
+    {
+        out = WriteLEDImageHex(out, (const uint8_t *) palette, colors * 3);
+
+        if (chosen == 1 && colors <= 16)
+        {
+            //two pixels per byte, the last low nibble is padding for odd sizes
+            for (size_t i = 0; i < count; i += 2)
+            {
+                uint8_t pair = (indices[i] << 4) | ((i + 1 < count) ? indices[i + 1] : 0);
+                out = WriteLEDImageHex(out, &pair, 1);
+            }
+        }
+        else if (chosen == 1)
+            out = WriteLEDImageHex(out, indices, count);
+        else
+        {
+            for (size_t i = 0; i < count;)
+            {
+                size_t run = 1;
+                while (i + run < count && run < 256 && indices[i + run] == indices[i])
+                    run++;
+
+                uint8_t pair[2] = { (uint8_t) (run - 1), indices[i] };
+                out = WriteLEDImageHex(out, pair, 2);
+                i += run;
+            }
+        }
+    }
+
+    *out = '\0';
+
+    String encoded(text);
+    free(text);
+    free(indices);
+
+    return encoded;
+}
+
+//Gets the number of pixels of a stored image from its header (plain RRGGBB without one: length / 6),
+//  0 if the header is malformed or the image larger than LED_IMAGE_MAX_PIXELS
+size_t GetLEDImagePixelCount(const char *data, size_t length)
+{
+    int values[3] = { 0, 0, 0 };
+    size_t headerLength = 0;
+    uint64_t count = 0;
+
+    if (length >= 2 && data[0] == '@' && (data[1] == 'P' || data[1] == 'R'))
+    {
+        if (ParseLEDImageHeader(data, length, values, 3, headerLength))
+            count = (uint64_t) values[0] * values[1];
+    }
+    else if (length >= 2 && data[0] == '@' && data[1] == 'I')
+    {
+        if (ParseLEDImageHeader(data, length, values, 2, headerLength))
+            count = (uint64_t) values[0] * values[1];
+    }
+    else
+        count = length / 6;
+
+    return (count <= LED_IMAGE_MAX_PIXELS) ? (size_t) count : 0;
+}
+
+//Gets the length of a stored image as plain RRGGBB hexadecimal, from its first characters
+size_t GetLEDImageRawLength(const char *data, size_t length, size_t fileLength)
+{
+    int values[3] = { 0, 0, 0 };
+    size_t headerLength = 0;
+    uint64_t raw = fileLength;
+
+    if (length < 2 || data[0] != '@')
+        return fileLength;
+
+    //64-bit: header values reach 655359, their product would wrap a 32-bit size_t
+    switch (data[1])
+    {
+        case 'I':
+            if (ParseLEDImageHeader(data, length, values, 2, headerLength))
+                raw = (uint64_t) values[0] * values[1] * 6;
+            break;
+        case 'P':
+        case 'R':
+            if (ParseLEDImageHeader(data, length, values, 3, headerLength))
+                raw = (uint64_t) values[0] * values[1] * 6;
+            break;
+        case 'A':
+        case 'D':
+            //animation: duration and pixels of every frame
+            if (ParseLEDImageHeader(data, length, values, 3, headerLength))
+                raw = (uint64_t) values[2] * (4 + (uint64_t) values[0] * values[1] * 6);
+            break;
+    }
+
+    return (raw <= SIZE_MAX) ? (size_t) raw : fileLength;
+}
+
+//Draws an image onto a matrix sized LED array, using integer arithmetic only
+void BlitLEDImage(const LedImage &image, CRGB *target, LedImageMode mode)
+{
+    //same size: straight copy whatever the mode
+    if (image.width == LED_MATRIX_WIDTH && image.height == LED_MATRIX_HEIGHT)
+        mode = LED_IMAGE_CENTER;
+
+    switch (mode)
+    {
+        case LED_IMAGE_BILINEAR:
+            BlitLEDImageBilinear(image, target);
+            break;
+        case LED_IMAGE_CENTER:
+            BlitLEDImageOffset(image, target, false);
+            break;
+        case LED_IMAGE_TILE:
+            BlitLEDImageOffset(image, target, true);
+            break;
+        default:
+            BlitLEDImageNearest(image, target);
+            break;
+    }
+}
+
+//Stretches the image, sampling the source pixel under each matrix pixel centre
+void BlitLEDImageNearest(const LedImage &image, CRGB *target)
+{
+    uint32_t stepX = ((uint32_t) image.width << 16) / LED_MATRIX_WIDTH;
+    uint32_t stepY = ((uint32_t) image.height << 16) / LED_MATRIX_HEIGHT;
+
+    //source column of every matrix column
+    uint16_t columns[LED_MATRIX_WIDTH];
+    for (int x = 0; x < LED_MATRIX_WIDTH; x++)
+        columns[x] = (x * stepX + stepX / 2) >> 16;
+
+    for (int y = 0; y < LED_MATRIX_HEIGHT; y++)
+    {
+        const CRGB *row = image.pixels + ((y * stepY + stepY / 2) >> 16) * image.width;
+
+        for (int x = 0; x < LED_MATRIX_WIDTH; x++)
+            target[LEDMatrixXY(x, y)] = row[columns[x]];
+    }
+}
+
+//Gets the two source samples and the 8 bit weight of the second for a matrix coordinate
+static inline void GetBilinearSamples(int pos, uint32_t step, int size, uint16_t &first, uint16_t &second, uint8_t &weight)
+{
+    //centre of the matrix pixel in source coordinates, minus half a pixel
+    int32_t fixed = (int32_t) (pos * step + step / 2) - FIXED_HALF;
+    int32_t last = (int32_t) (size - 1) << 16;
+
+    if (fixed < 0)
+        fixed = 0;
+    else if (fixed > last)
+        fixed = last;
+
+    first = fixed >> 16;
+    second = (first + 1 < size) ? first + 1 : first;
+    weight = (fixed >> 8) & 0xFF;
+}
+
+//Blends two colours, weight 0 gives a, 255 almost b
+static inline CRGB LerpLEDColor(const CRGB &a, const CRGB &b, uint8_t weight)
+{
+    uint16_t wb = weight;
+    uint16_t wa = 256 - wb;
+
+    return CRGB((a.r * wa + b.r * wb) >> 8, (a.g * wa + b.g * wb) >> 8, (a.b * wa + b.b * wb) >> 8);
+}
+
+//Stretches the image, filtering the 4 source pixels around each matrix pixel centre
+void BlitLEDImageBilinear(const LedImage &image, CRGB *target)
+{
+    uint32_t stepX = ((uint32_t) image.width << 16) / LED_MATRIX_WIDTH;
+    uint32_t stepY = ((uint32_t) image.height << 16) / LED_MATRIX_HEIGHT;
+
+    uint16_t x0[LED_MATRIX_WIDTH];
+    uint16_t x1[LED_MATRIX_WIDTH];
+    uint8_t wx[LED_MATRIX_WIDTH];
+    for (int x = 0; x < LED_MATRIX_WIDTH; x++)
+        GetBilinearSamples(x, stepX, image.width, x0[x], x1[x], wx[x]);
+
+    for (int y = 0; y < LED_MATRIX_HEIGHT; y++)
+    {
+        uint16_t y0, y1;
+        uint8_t wy;
+        GetBilinearSamples(y, stepY, image.height, y0, y1, wy);
+
+        const CRGB *top = image.pixels + y0 * image.width;
+        const CRGB *bottom = image.pixels + y1 * image.width;
+
+        for (int x = 0; x < LED_MATRIX_WIDTH; x++)
+        {
+            CRGB upper = LerpLEDColor(top[x0[x]], top[x1[x]], wx[x]);
+            CRGB lower = LerpLEDColor(bottom[x0[x]], bottom[x1[x]], wx[x]);
+            target[LEDMatrixXY(x, y)] = LerpLEDColor(upper, lower, wy);
+        }
+    }
+}
+
+//Copies the image at its own size, centred (cropped or black borders) or tiled
+void BlitLEDImageOffset(const LedImage &image, CRGB *target, bool tile)
+{
+    int offsetX = tile ? 0 : (LED_MATRIX_WIDTH - image.width) / 2;
+    int offsetY = tile ? 0 : (LED_MATRIX_HEIGHT - image.height) / 2;
+
+    for (int y = 0; y < LED_MATRIX_HEIGHT; y++)
+    {
+        int sy = tile ? y % image.height : y - offsetY;
+
+        for (int x = 0; x < LED_MATRIX_WIDTH; x++)
+        {
+            int sx = tile ? x % image.width : x - offsetX;
+
+            if (sx < 0 || sy < 0 || sx >= image.width || sy >= image.height)
+                target[LEDMatrixXY(x, y)] = CRGB::Black;
+            else
+                target[LEDMatrixXY(x, y)] = image.pixels[sy * image.width + sx];
+        }
+    }
+}
+
+//Gets the image mode matching a name (nearest, bilinear, center, tile), nearest if unknown
+LedImageMode ParseLEDImageMode(String name)
+{
+    name.trim();
+    name.toLowerCase();
+
+    for (int i = 0; i < (int) (sizeof(ledImageModeNames) / sizeof(ledImageModeNames[0])); i++)
+        if (name == ledImageModeNames[i])
+            return (LedImageMode) i;
+
+    return LED_IMAGE_NEAREST;
+}
+
+//Gets the name of an image mode
+const char *GetLEDImageModeName(LedImageMode mode)
+{
+    return ledImageModeNames[mode];
+}
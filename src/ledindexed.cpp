@@ -0,0 +1,86 @@
+//+--------------------------------------------------------------------------
+//
+// File:        ledindexed.cpp
+//
+// Description: The purpose of this file is to provide an 8-bit indexed
+//              frame with a 256 colour palette. Effects whose colours
+//              follow a value (heat, hue, pulse phase) write the value once
+//              and animate by rotating the palette; the output stage looks
+//              the palette up only when the frame is shown. It saves per
+//              pixel work, not memory: the frame comes on top of the LED
+//              array, and the overlay layers stay CRGB with alpha.
+//
+// History:     2026-10-18    PP Laplante   Created
+//
+//
+//---------------------------------------------------------------------------
+#include <Arduino.h>
+#include <FastLED.h>
+#include <ledconfig.h>
+#include <ledindexed.h>
+
+//Global variables
+uint8_t ledIndexedFrame[LED_NUM_LEDS];          //palette index of every LED
+CRGB ledIndexedPalette[256];                    //colours of the indices
+uint8_t ledIndexedOffset = 0;                   //palette rotation
+bool ledIndexedEnabled = false;                 //current effect draws into the indexed frame
+
+//Enables the indexed frame for the current effect (clears it), or goes back to the LED array
+void SetLEDIndexedEnabled(bool enabled)
+{
+    if (enabled && !ledIndexedEnabled)
+    {
+        memset(ledIndexedFrame, 0, sizeof(ledIndexedFrame));
+        ledIndexedOffset = 0;
+    }
+
+    ledIndexedEnabled = enabled;
+}
+
+//Gets whether the current effect draws into the indexed frame
+bool GetLEDIndexedEnabled()
+{
+    return ledIndexedEnabled;
+}
+
+//Gets the indexed frame (LED_NUM_LEDS palette indices, strip order)
+uint8_t *GetLEDIndexedFrame()
+{
+    return ledIndexedFrame;
+}
+
+//Gets the palette of the indexed frame (256 colours)
+CRGB *GetLEDIndexedPalette()
+{
+    return ledIndexedPalette;
+}
+
+//Sets the rotation of the palette: index i shows palette colour (i + offset)
+void SetLEDIndexedPaletteOffset(uint8_t offset)
+{
+    ledIndexedOffset = offset;
+}
+
+//Gets the rotation of the palette
+uint8_t GetLEDIndexedPaletteOffset()
+{
+    return ledIndexedOffset;
+}
+
+//Rotates the palette by a number of entries
+void RotateLEDIndexedPalette(int steps)
+{
+    ledIndexedOffset += steps;
+}
+
+//Expands the indexed frame through the rotated palette into a LED array
+void ExpandLEDIndexedFrame(CRGB *target)
+{
+    //rotate the palette once rather than adding the offset for every LED
+    CRGB rotated[256];
+    for (int i = 0; i < 256; i++)
+        rotated[i] = ledIndexedPalette[(uint8_t) (i + ledIndexedOffset)];
+
+    for (int i = 0; i < LED_NUM_LEDS; i++)
+        target[i] = rotated[ledIndexedFrame[i]];
+}
@@ -0,0 +1,273 @@
+//+--------------------------------------------------------------------------
+//
+// File:        ledlayers.cpp
+//
+// Description: The purpose of this file is to provide a small layer stack
+//              drawn over the base effect: each overlay has its own colour
+//              and alpha buffer, a blend mode and an opacity. Layers are
+//              composited once per frame shown with integer kernels; rows
+//              a layer never drew on are skipped entirely. Rows are split
+//              between both cores.
+//
+// History:     2026-10-18    PP Laplante   Created
+//
+//
+//---------------------------------------------------------------------------
+#include <Arduino.h>
+#include <ArduinoJson.h>
+#include <FastLED.h>
+#include <traceutils.h>
+#include <ledconfig.h>
+#include <ledmatrix.h>
+#include <ledlayers.h>
+#include <parallelutils.h>
+
+static_assert(LED_MATRIX_HEIGHT <= 64, "row occupancy mask holds 64 rows");
+
+struct LedLayer
+{
+    CRGB            pixels[LED_NUM_LEDS];   //colour, strip order
+    uint8_t         alpha[LED_NUM_LEDS];    //coverage, 0 = transparent
+    uint64_t        rows = 0;               //rows holding at least one non transparent pixel
+    LedBlendMode    mode = LED_BLEND_NORMAL;
+    uint8_t         opacity = 255;
+    bool            visible = true;
+};
+
+const char *ledBlendModeNames[] = { "normal", "add", "multiply", "screen" };
+const char *ledLayerNames[LED_LAYER_COUNT] = { "sprites", "overlay", "clock", "status" };
+
+//Global variables
+LedLayer ledLayers[LED_LAYER_COUNT];            //overlay stack, bottom to top
+CRGB ledComposite[LED_NUM_LEDS];                //base frame with the layers over it
+bool ledLayersChanged = false;                  //a layer changed since the last composite
+
+//Local Prototypes
+void BlendLEDLayerRow(const LedLayer &layer, CRGB *target, int start);
+void CompositeLEDLayerRows(int first, int last, void *context);
+
+//Validates a layer index
+static inline bool IsLEDLayerIndex(int layer)
+{
+    return layer >= 0 && layer < LED_LAYER_COUNT;
+}
+
+//Clears a layer to fully transparent
+void ClearLEDLayer(int layer)
+{
+    if (!IsLEDLayerIndex(layer))
+        return;
+
+    LedLayer &l = ledLayers[layer];
+
+    //only a drawn layer changes the composite
+    if (l.rows != 0)
+    {
+        memset(l.alpha, 0, sizeof(l.alpha));
+        l.rows = 0;
+        ledLayersChanged = true;
+    }
+}
+
+//Sets a layer pixel in matrix coordinates, alpha 0 is transparent
+void SetLEDLayerPixel(int layer, int x, int y, CRGB color, uint8_t alpha)
+{
+    if (!IsLEDLayerIndex(layer) || x < 0 || y < 0 || x >= LED_MATRIX_WIDTH || y >= LED_MATRIX_HEIGHT)
+        return;
+
+    LedLayer &l = ledLayers[layer];
+    uint16_t i = LEDMatrixXY(x, y);
+
+    if (l.alpha[i] == alpha && (alpha == 0 || l.pixels[i] == color))
+        return;
+
+    l.pixels[i] = color;
+    l.alpha[i] = alpha;
+
+    //rows are only marked, a row cleared pixel by pixel stays marked until ClearLEDLayer
+    if (alpha != 0)
+        l.rows |= 1ULL << y;
+
+    ledLayersChanged = true;
+}
+
+//Fills a rectangle of a layer in matrix coordinates (clipped)
+void FillLEDLayerRect(int layer, int x, int y, int width, int height, CRGB color, uint8_t alpha)
+{
+    for (int j = y; j < y + height; j++)
+        for (int i = x; i < x + width; i++)
+            SetLEDLayerPixel(layer, i, j, color, alpha);
+}
+
+//Sets how a layer is blended and its overall opacity
+void SetLEDLayerBlend(int layer, LedBlendMode mode, uint8_t opacity)
+{
+    if (!IsLEDLayerIndex(layer))
+        return;
+
+    ledLayers[layer].mode = mode;
+    ledLayers[layer].opacity = opacity;
+    ledLayersChanged = true;
+}
+
+//Shows or hides a layer without clearing it
+void SetLEDLayerVisible(int layer, bool visible)
+{
+    if (!IsLEDLayerIndex(layer) || ledLayers[layer].visible == visible)
+        return;
+
+    ledLayers[layer].visible = visible;
+    ledLayersChanged = true;
+}
+
+//Gets whether a layer holds anything visible
+bool IsLEDLayerVisible(int layer)
+{
+    if (!IsLEDLayerIndex(layer))
+        return false;
+
+    const LedLayer &l = ledLayers[layer];
+
+    return l.visible && l.opacity != 0 && l.rows != 0;
+}
+
+//Gets whether any layer holds anything visible
+bool AnyLEDLayerVisible()
+{
+    for (int l = 0; l < LED_LAYER_COUNT; l++)
+        if (IsLEDLayerVisible(l))
+            return true;
+
+    return false;
+}
+
+//Gets whether a layer changed since the last composite
+bool GetLEDLayersChanged()
+{
+    return ledLayersChanged;
+}
+
+//Mixes b over a, alpha 255 gives b exactly
+static inline uint8_t Mix8(uint8_t a, uint8_t b, uint8_t alpha)
+{
+    return a + ((((int) b - a) * (alpha + (alpha >> 7))) >> 8);
+}
+
+//Blends one row of a layer over the composite
+void BlendLEDLayerRow(const LedLayer &layer, CRGB *target, int start)
+{
+    for (int i = start; i < start + LED_MATRIX_WIDTH; i++)
+    {
+        uint8_t alpha = layer.alpha[i];
+
+        if (alpha == 0)
+            continue;
+
+        //fold the layer opacity into the pixel coverage
+        alpha = ((uint16_t) alpha * layer.opacity + 255) >> 8;
+
+        CRGB &d = target[i];
+        CRGB s = layer.pixels[i];
+
+        switch (layer.mode)
+        {
+            case LED_BLEND_ADD:
+                s = CRGB(qadd8(d.r, s.r), qadd8(d.g, s.g), qadd8(d.b, s.b));
+                break;
+            case LED_BLEND_MULTIPLY:
+                s = CRGB((d.r * s.r + 255) >> 8, (d.g * s.g + 255) >> 8, (d.b * s.b + 255) >> 8);
+                break;
+            case LED_BLEND_SCREEN:
+                s = CRGB(255 - (((255 - d.r) * (255 - s.r) + 255) >> 8),
+                         255 - (((255 - d.g) * (255 - s.g) + 255) >> 8),
+                         255 - (((255 - d.b) * (255 - s.b) + 255) >> 8));
+                break;
+            default:
+                break;
+        }
+
+        d.r = Mix8(d.r, s.r, alpha);
+        d.g = Mix8(d.g, s.g, alpha);
+        d.b = Mix8(d.b, s.b, alpha);
+    }
+}
+
+//Composites the visible layers over the base frame, returns the frame to show
+const CRGB *CompositeLEDLayers(const CRGB *base)
+{
+    ledLayersChanged = false;
+
+    //nothing over the base: no copy at all
+    if (!AnyLEDLayerVisible())
+        return base;
+
+    TRACE_SCOPE("CompositeLEDLayers");
+
+    //rows are independent, split between both cores
+    ParallelForRows(LED_MATRIX_HEIGHT, CompositeLEDLayerRows, (void *) base);
+
+    return ledComposite;
+}
+
+//Composites rows [first, last) of the visible layers over the base frame (context)
+void CompositeLEDLayerRows(int first, int last, void *context)
+{
+    const CRGB *base = (const CRGB *) context;
+
+    memcpy(&ledComposite[first * LED_MATRIX_WIDTH], &base[first * LED_MATRIX_WIDTH], (last - first) * LED_MATRIX_WIDTH * sizeof(CRGB));
+
+    //occupied rows of the range only
+    uint64_t range = ((last >= 64) ? ~0ULL : (1ULL << last) - 1) & ~((1ULL << first) - 1);
+
+    for (int l = 0; l < LED_LAYER_COUNT; l++)
+    {
+        if (!IsLEDLayerVisible(l))
+            continue;
+
+        uint64_t rows = ledLayers[l].rows & range;
+        while (rows != 0)
+        {
+            int y = __builtin_ctzll(rows);
+            rows &= rows - 1;
+
+            BlendLEDLayerRow(ledLayers[l], ledComposite, y * LED_MATRIX_WIDTH);
+        }
+    }
+}
+
+//Gets the blend mode matching a name (normal, add, multiply, screen), normal if unknown
+LedBlendMode ParseLEDBlendMode(String name)
+{
+    name.trim();
+    name.toLowerCase();
+
+    for (int i = 0; i < (int) (sizeof(ledBlendModeNames) / sizeof(ledBlendModeNames[0])); i++)
+        if (name == ledBlendModeNames[i])
+            return (LedBlendMode) i;
+
+    return LED_BLEND_NORMAL;
+}
+
+//Gets the layer states as JSON
+String SerializeLEDLayers()
+{
+    String info = "";
+    StaticJsonDocument<1024> doc;
+
+    JsonArray layers = doc.createNestedArray("layers");
+    for (int i = 0; i < LED_LAYER_COUNT; i++)
+    {
+        const LedLayer &l = ledLayers[i];
+
+        JsonObject layer = layers.createNestedObject();
+        layer["name"] = ledLayerNames[i];
+        layer["visible"] = l.visible;
+        layer["blend"] = ledBlendModeNames[l.mode];
+        layer["opacity"] = l.opacity;
+        layer["rows"] = __builtin_popcountll(l.rows);
+    }
+
+    serializeJson(doc, info);
+
+    return info;
+}
@@ -0,0 +1,460 @@
+//+--------------------------------------------------------------------------
+//
+// File:        ledoutput.cpp
+//
+// Description: The purpose of this file is to provide the output stage of
+//              the LED strip: gamma, white balance correction and global
+//              brightness are combined into one precomputed lookup table per
+//              channel, applied in a single pass just before FastLED.show().
+//              The table is only rebuilt when one of the settings changes.
+//              The same pass keeps a per channel sum of the frame for each
+//              block of LEDs it converts, so the running total used to
+//              estimate the current draw, and dim the strip to stay under a
+//              power limit, only costs the blocks that changed.
+//              Indexed frames go through the LUT one palette entry at a
+//              time, then cost a single lookup per LED.
+//              A frame identical to what the strip already shows is not
+//              pushed again: FastLED.show() keeps interrupts disabled for
+//              the whole transfer, which hurts WiFi on the ESP32.
+//              Frames are converted into the back buffer of the output
+//              pipeline, shown while the next frame is computed.
+//
+// History:     2026-10-18    PP Laplante   Created
+//
+//
+//---------------------------------------------------------------------------
+#include <Arduino.h>
+#include <FastLED.h>
+#include <traceutils.h>
+#include <logutils.h>
+#include <ledconfig.h>
+#include <ledoutput.h>
+#include <ledpipeline.h>
+
+//Current drawn by one channel at full duty, and by a dark pixel (mA)
+const uint32_t ledPowerChannelMa[3] = { 16, 11, 15 };
+#define LED_POWER_IDLE_MA       1
+
+//LEDs per block of the power sums: a changed range is widened to whole blocks
+#define LED_POWER_BLOCK         16
+#define LED_POWER_BLOCKS        ((LED_NUM_LEDS + LED_POWER_BLOCK - 1) / LED_POWER_BLOCK)
+
+//Global variables
+CLEDController *ledOutputController = NULL;             //strip registered with FastLED
+uint16_t ledOutputBase[3][256];                         //gamma and correction, full brightness (0-65535)
+uint8_t ledOutputLUT[3][256];                           //per channel lookup table
+bool ledOutputBaseDirty = true;                         //base table must be rebuilt before use
+bool ledOutputLUTDirty = true;                          //LUT must be rebuilt before use
+uint8_t ledOutputBrightness = 255;                      //global brightness requested
+uint8_t ledOutputLimitedBrightness = 255;               //global brightness after power limiting
+float ledOutputGamma = LED_OUTPUT_GAMMA;                //gamma exponent
+uint32_t ledOutputCorrection = LED_OUTPUT_CORRECTION;   //white balance 0xRRGGBB
+
+uint32_t ledPowerBlockSum[LED_POWER_BLOCKS][3];         //sum of base table values per block and channel
+uint32_t ledPowerSum[3] = { 0, 0, 0 };                  //sum of base table values per channel (of the blocks, or of the indexed frame)
+unsigned long ledPowerLimit = LED_POWER_LIMIT_MA;       //current limit (0 = unlimited)
+unsigned long ledPowerEstimate = 0;                     //estimated draw of the last frame shown
+bool ledPowerRecovering = false;                        //brightness below the request after a limiter cut, ramping back
+
+const CRGB *ledOutputSource = NULL;                     //frame converted last, NULL after an indexed frame
+bool ledOutputRefresh = true;                           //push the next frame even if unchanged (strip state unknown)
+unsigned long ledOutputShowCount = 0;                   //frames pushed to the strip
+unsigned long ledOutputSkipCount = 0;                   //frames not pushed, identical to the strip
+
+//Local Prototypes
+void BuildLEDOutputBase();
+void BuildLEDOutputLUT();
+bool ConvertLEDOutputBlocks(const CRGB *frame, int first, int last);
+void UpdateLEDPowerSumsIndexed(const uint8_t *indices, const CRGB *palette, uint8_t offset);
+uint8_t GetLEDPowerLimitedBrightness();
+bool PrepareLEDOutputLUT();
+void PushLEDOutput(bool changed, int first, int count);
+void ShowLEDOutputDriver(const CRGB *buffer, int count);
+
+//Initializes the output buffer and registers it with FastLED
+void InitLEDOutput()
+{
+    //brightness and correction are applied by the LUT, not by FastLED
+    ledOutputController = &FastLED.addLeds<WS2812, LED_GPIO_PIN, GRB>((CRGB *) GetLEDPipelineFrontBuffer(), LED_NUM_LEDS);
+    FastLED.setBrightness(255);
+
+    BuildLEDOutputBase();
+    BuildLEDOutputLUT();
+
+    //FastLED.show() runs on the output task from now on
+    InitLEDPipeline(ShowLEDOutputDriver);
+}
+
+//Pipeline driver: shows the buffer handed over (output task)
+void ShowLEDOutputDriver(const CRGB *buffer, int count)
+{
+    ledOutputController->setLeds((CRGB *) buffer, count);
+    FastLED.show();
+}
+
+//Rebuilds the gamma and correction table, slow (powf) but only on settings change
+void BuildLEDOutputBase()
+{
+    TRACE_SCOPE("BuildLEDOutputBase");
+
+    for (int c = 0; c < 3; c++)
+    {
+        uint32_t correction = (ledOutputCorrection >> (16 - c*8)) & 0xFF;
+        float scale = correction / 255.0f;
+
+        for (int v = 0; v < 256; v++)
+        {
+            float linear = powf(v / 255.0f, ledOutputGamma);
+            ledOutputBase[c][v] = (uint16_t) (linear * scale * 65535.0f + 0.5f);
+        }
+    }
+
+    ledOutputBaseDirty = false;
+    ledOutputLUTDirty = true;
+
+    LOG_DEBUG("Output LUT rebuilt: gamma %.2f, correction %06X", ledOutputGamma, (unsigned int) ledOutputCorrection);
+}
+
+//Folds the brightness into the base table, cheap enough to run on every brightness step
+void BuildLEDOutputLUT()
+{
+    uint32_t brightness = ledOutputLimitedBrightness;
+
+    for (int c = 0; c < 3; c++)
+        for (int v = 0; v < 256; v++)
+            ledOutputLUT[c][v] = (ledOutputBase[c][v] * brightness + 32767) / 65535;
+
+    ledOutputLUTDirty = false;
+}
+
+//Converts the blocks of LEDs in [first, last) through the LUT into the back buffer, replacing their power sums
+//  in the running total, returns true if any LED differs from what the strip shows
+bool ConvertLEDOutputBlocks(const CRGB *frame, int first, int last)
+{
+    const uint8_t *lutR = ledOutputLUT[0];
+    const uint8_t *lutG = ledOutputLUT[1];
+    const uint8_t *lutB = ledOutputLUT[2];
+    const uint16_t *baseR = ledOutputBase[0];
+    const uint16_t *baseG = ledOutputBase[1];
+    const uint16_t *baseB = ledOutputBase[2];
+    CRGB *output = GetLEDPipelineBackBuffer();
+    const CRGB *shown = GetLEDPipelineFrontBuffer();
+    bool changed = false;
+
+    for (int block = first; block < last; block += LED_POWER_BLOCK)
+    {
+        int end = min(block + LED_POWER_BLOCK, last);
+        uint32_t sumR = 0, sumG = 0, sumB = 0;
+
+        //one table lookup per channel, into the buffer the strip is not showing
+        for (int i = block; i < end; i++)
+        {
+            const CRGB &pixel = frame[i];
+
+            output[i] = CRGB(lutR[pixel.r], lutG[pixel.g], lutB[pixel.b]);
+            changed |= output[i] != shown[i];
+
+            sumR += baseR[pixel.r];
+            sumG += baseG[pixel.g];
+            sumB += baseB[pixel.b];
+        }
+
+        uint32_t *sum = ledPowerBlockSum[block / LED_POWER_BLOCK];
+        ledPowerSum[0] += sumR - sum[0];
+        ledPowerSum[1] += sumG - sum[1];
+        ledPowerSum[2] += sumB - sum[2];
+        sum[0] = sumR;
+        sum[1] = sumG;
+        sum[2] = sumB;
+    }
+
+    return changed;
+}
+
+//Computes the per channel sums of an indexed frame from the use count of each index
+void UpdateLEDPowerSumsIndexed(const uint8_t *indices, const CRGB *palette, uint8_t offset)
+{
+    uint16_t histogram[256];
+    memset(histogram, 0, sizeof(histogram));
+
+    for (int i = 0; i < LED_NUM_LEDS; i++)
+        histogram[indices[i]]++;
+
+    //the block sums no longer add up to the total: the next frame is converted whole (source changed)
+    ledPowerSum[0] = ledPowerSum[1] = ledPowerSum[2] = 0;
+    for (int k = 0; k < 256; k++)
+    {
+        if (histogram[k] == 0)
+            continue;
+
+        const CRGB &color = palette[(uint8_t) (k + offset)];
+        ledPowerSum[0] += histogram[k] * ledOutputBase[0][color.r];
+        ledPowerSum[1] += histogram[k] * ledOutputBase[1][color.g];
+        ledPowerSum[2] += histogram[k] * ledOutputBase[2][color.b];
+    }
+}
+
+//Estimates the current drawn by the frame in the sums at a given brightness (mA)
+unsigned long EstimateLEDPower(uint8_t brightness)
+{
+    uint64_t full = 0;
+    for (int c = 0; c < 3; c++)
+        full += (uint64_t) ledPowerSum[c] * ledPowerChannelMa[c];
+
+    return LED_NUM_LEDS * LED_POWER_IDLE_MA + (unsigned long) (full * brightness / (65535ULL * 255ULL));
+}
+
+//Gets the brightness to use for the frame in the sums: dims at once when over
+//the limit, recovers from a cut a few steps per frame so the change is not
+//visible; brightness requests are applied at once
+uint8_t GetLEDPowerLimitedBrightness()
+{
+    uint8_t target = ledOutputBrightness;
+
+    if (ledPowerLimit == 0)
+        return target;
+
+    unsigned long idle = LED_NUM_LEDS * LED_POWER_IDLE_MA;
+    unsigned long draw = EstimateLEDPower(target) - idle;
+    unsigned long available = ledPowerLimit > idle ? ledPowerLimit - idle : 0;
+
+    if (draw > available)
+        target = (uint8_t) ((uint32_t) target * available / draw);
+
+    uint8_t current = ledOutputLimitedBrightness;
+
+    if (target < current || !ledPowerRecovering)
+        return target;
+
+    return (target - current > LED_POWER_RAMP_STEP) ? current + LED_POWER_RAMP_STEP : target;
+}
+
+//Applies the power limit to the frame in the sums and brings the LUT up to date, returns true if the LUT changed
+bool PrepareLEDOutputLUT()
+{
+    uint8_t brightness = GetLEDPowerLimitedBrightness();
+    if (brightness != ledOutputLimitedBrightness)
+    {
+        ledOutputLimitedBrightness = brightness;
+        ledOutputLUTDirty = true;
+    }
+
+    ledPowerRecovering = (ledOutputLimitedBrightness < ledOutputBrightness);
+
+    bool changed = ledOutputLUTDirty;
+    if (ledOutputLUTDirty)
+        BuildLEDOutputLUT();
+
+    ledPowerEstimate = EstimateLEDPower(ledOutputLimitedBrightness);
+
+    return changed;
+}
+
+//Hands the back buffer, converted in [first, first+count), to the strip unless it holds what the strip already shows
+void PushLEDOutput(bool changed, int first, int count)
+{
+    if (!changed && !ledOutputRefresh)
+    {
+        ledOutputSkipCount++;
+        return;
+    }
+
+    //the LEDs outside the range are the ones already shown
+    CRGB *output = GetLEDPipelineBackBuffer();
+    const CRGB *shown = GetLEDPipelineFrontBuffer();
+
+    memcpy(output, shown, first * sizeof(CRGB));
+    memcpy(output + first + count, shown + first + count, (LED_NUM_LEDS - first - count) * sizeof(CRGB));
+
+    ledOutputRefresh = false;
+    ledOutputShowCount++;
+
+    SubmitLEDPipelineFrame();
+}
+
+//Converts a frame through the output LUT and pushes it to the strip
+void ShowLEDOutput(const CRGB *frame)
+{
+    ShowLEDOutputRange(frame, 0, LED_NUM_LEDS);
+}
+
+//Converts the LEDs of a frame that changed since the last one through the output LUT and pushes it to the strip
+void ShowLEDOutputRange(const CRGB *frame, int first, int count)
+{
+    //a new base table changes the units of the sums: convert and sum every block again
+    if (ledOutputBaseDirty)
+    {
+        BuildLEDOutputBase();
+        ledOutputSource = NULL;
+    }
+
+    //another frame than last time (composite, indexed): every pixel may differ
+    if (frame != ledOutputSource)
+    {
+        first = 0;
+        count = LED_NUM_LEDS;
+    }
+
+    //clip
+    if (first < 0)
+    {
+        count += first;
+        first = 0;
+    }
+    if (count > LED_NUM_LEDS - first)
+        count = LED_NUM_LEDS - first;
+    if (count < 0)
+        count = 0;
+
+    //the sums are kept per block, widen the range to whole blocks
+    int last = first + count;
+    first -= first % LED_POWER_BLOCK;
+    last = min(LED_NUM_LEDS, (last + LED_POWER_BLOCK - 1) / LED_POWER_BLOCK * LED_POWER_BLOCK);
+
+    //a whole frame starts the sums over (stale after an indexed frame or a new base)
+    if (first == 0 && last == LED_NUM_LEDS)
+    {
+        memset(ledPowerBlockSum, 0, sizeof(ledPowerBlockSum));
+        ledPowerSum[0] = ledPowerSum[1] = ledPowerSum[2] = 0;
+    }
+
+    //convert with the current LUT, the sums are only known once the range is converted
+    if (ledOutputLUTDirty)
+        BuildLEDOutputLUT();
+
+    bool changed = ConvertLEDOutputBlocks(frame, first, last);
+
+    //a new LUT (brightness, power limit) changes every pixel: convert again with it (the sums do not change)
+    if (PrepareLEDOutputLUT())
+    {
+        first = 0;
+        last = LED_NUM_LEDS;
+        changed = ConvertLEDOutputBlocks(frame, first, last);
+    }
+
+    ledOutputSource = frame;
+    PushLEDOutput(changed, first, last - first);
+}
+
+//Converts an indexed frame through its rotated palette and the output LUT and pushes it to the strip
+void ShowLEDOutputIndexed(const uint8_t *indices, const CRGB *palette, uint8_t offset)
+{
+    if (ledOutputBaseDirty)
+        BuildLEDOutputBase();
+
+    UpdateLEDPowerSumsIndexed(indices, palette, offset);
+    PrepareLEDOutputLUT();
+
+    //the LUT is applied to the 256 palette entries instead of every LED
+    CRGB output[256];
+    for (int k = 0; k < 256; k++)
+    {
+        const CRGB &color = palette[(uint8_t) (k + offset)];
+        output[k] = CRGB(ledOutputLUT[0][color.r], ledOutputLUT[1][color.g], ledOutputLUT[2][color.b]);
+    }
+
+    CRGB *back = GetLEDPipelineBackBuffer();
+    const CRGB *shown = GetLEDPipelineFrontBuffer();
+    bool changed = false;
+
+    for (int i = 0; i < LED_NUM_LEDS; i++)
+    {
+        back[i] = output[indices[i]];
+        changed |= back[i] != shown[i];
+    }
+
+    ledOutputSource = NULL;
+    PushLEDOutput(changed, 0, LED_NUM_LEDS);
+}
+
+//Sets the global brightness folded into the LUT (0-255)
+void SetLEDOutputBrightness(uint8_t brightness)
+{
+    ledOutputBrightness = brightness;
+}
+
+//Gets the global brightness folded into the LUT (0-255)
+uint8_t GetLEDOutputBrightness()
+{
+    return ledOutputBrightness;
+}
+
+//Sets the gamma folded into the LUT
+void SetLEDOutputGamma(float gamma)
+{
+    //keep it sane, 1.0 is linear
+    if (gamma < 0.1f || gamma > 5.0f)
+        gamma = LED_OUTPUT_GAMMA;
+
+    if (gamma != ledOutputGamma)
+    {
+        ledOutputGamma = gamma;
+        ledOutputBaseDirty = true;
+    }
+}
+
+//Gets the gamma folded into the LUT
+float GetLEDOutputGamma()
+{
+    return ledOutputGamma;
+}
+
+//Sets the white balance correction folded into the LUT (0xRRGGBB)
+void SetLEDOutputCorrection(uint32_t correction)
+{
+    correction &= 0xFFFFFF;
+
+    if (correction != ledOutputCorrection)
+    {
+        ledOutputCorrection = correction;
+        ledOutputBaseDirty = true;
+    }
+}
+
+//Gets the white balance correction folded into the LUT (0xRRGGBB)
+uint32_t GetLEDOutputCorrection()
+{
+    return ledOutputCorrection;
+}
+
+//Sets the current limit of the strip in mA (0 = unlimited)
+void SetLEDPowerLimit(unsigned long limit_ma)
+{
+    ledPowerLimit = limit_ma;
+}
+
+//Gets the current limit of the strip in mA (0 = unlimited)
+unsigned long GetLEDPowerLimit()
+{
+    return ledPowerLimit;
+}
+
+//Gets the estimated current drawn by the last frame shown in mA
+unsigned long GetLEDPowerEstimate()
+{
+    return ledPowerEstimate;
+}
+
+//Gets the brightness actually applied after power limiting (0-255)
+uint8_t GetLEDOutputLimitedBrightness()
+{
+    return ledOutputLimitedBrightness;
+}
+
+//Gets whether the output settings changed since the last frame shown (LUT, power limit ramp)
+bool GetLEDOutputPending()
+{
+    return ledOutputBaseDirty || ledOutputLUTDirty || GetLEDPowerLimitedBrightness() != ledOutputLimitedBrightness;
+}
+
+//Gets how many frames were pushed to the strip
+unsigned long GetLEDOutputShowCount()
+{
+    return ledOutputShowCount;
+}
+
+//Gets how many frames were not pushed, the strip already showing them
+unsigned long GetLEDOutputSkipCount()
+{
+    return ledOutputSkipCount;
+}
@@ -0,0 +1,56 @@
+//+--------------------------------------------------------------------------
+//
+// File:        ledpattern.cpp
+//
+// Description: The purpose of this file is to compile colour patterns into
+//              a compact palette plus index sequence, once, when the pattern
+//              is activated rather than on every frame.
+//
+// History:     2026-10-18    PP Laplante   Created
+//
+//
+//---------------------------------------------------------------------------
+#include <hexutils.h>
+#include <ledpattern.h>
+
+//Compiles RRGGBB hexadecimal text into a pattern, returns false if invalid or too large
+bool CompileLEDPattern(const char *hex, size_t hexLength, LedPattern &pattern, int *errorPos)
+{
+    uint8_t rgb[LED_PATTERN_MAX_LENGTH * 3];
+
+    pattern.paletteSize = 0;
+    pattern.length = 0;
+
+    int pixels = HexDecodePixels(hex, hexLength, rgb, LED_PATTERN_MAX_LENGTH, errorPos);
+    if (pixels <= 0)
+        return false;
+
+    for (int i = 0; i < pixels; i++)
+    {
+        uint32_t color = ((uint32_t) rgb[i*3] << 16) | ((uint32_t) rgb[i*3 + 1] << 8) | rgb[i*3 + 2];
+
+        //find colour in palette, add it if new
+        int index = 0;
+        while (index < pattern.paletteSize && pattern.palette[index] != color)
+            index++;
+
+        if (index == pattern.paletteSize)
+        {
+            if (pattern.paletteSize == LED_PATTERN_MAX_COLORS)
+            {
+                if (errorPos != NULL)
+                    *errorPos = i * 6;
+                pattern.length = 0;
+                return false;
+            }
+
+            pattern.palette[pattern.paletteSize++] = color;
+        }
+
+        pattern.indexes[i] = index;
+    }
+
+    pattern.length = pixels;
+
+    return true;
+}
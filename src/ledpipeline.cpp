@@ -0,0 +1,199 @@
+//+--------------------------------------------------------------------------
+//
+// File:        ledpipeline.cpp
+//
+// Description: The purpose of this file is to provide a double buffered,
+//              pipelined output: a finished frame is handed to the driver
+//              on its own task and the next frame is computed into the
+//              other buffer meanwhile. The only wait is a fence before the
+//              next handoff, if the driver is still busy with the previous
+//              frame. On the host the task is a thread, so the timing can be
+//              exercised with a driver simulating the strip latency.
+//
+// History:     2026-10-18    PP Laplante   Created
+//
+//
+//---------------------------------------------------------------------------
+#include <Arduino.h>
+#include <FastLED.h>
+#include <traceutils.h>
+#include <ledpipeline.h>
+
+#if LED_PIPELINE_ENABLED && !defined(ESP32)
+#include <condition_variable>
+#include <mutex>
+#include <thread>
+#endif
+
+//Global variables
+CRGB ledPipelineBuffers[2][LED_NUM_LEDS];           //front (handed to the driver) and back buffers
+int ledPipelineFront = 0;                           //index of the front buffer
+LedPipelineDriver ledPipelineDriver = NULL;         //pushes a buffer to the strip
+bool ledPipelineBusy = false;                       //last frame handed over not confirmed done yet
+unsigned long ledPipelineFrames = 0;                //frames handed to the driver
+unsigned long ledPipelineWaitTime = 0;              //time spent in the fence (us)
+volatile unsigned long ledPipelineDriverTime = 0;   //driver time of the last frame (us), output task
+
+#if LED_PIPELINE_ENABLED
+#ifdef ESP32
+TaskHandle_t ledPipelineTask = NULL;                //output task
+SemaphoreHandle_t ledPipelineDone = NULL;           //given by the output task after each frame
+#else
+std::mutex *ledPipelineMutex = NULL;                //guards the flags below (never freed: the thread outlives main)
+std::condition_variable *ledPipelineSignal = NULL;  //flags changed
+bool ledPipelineSubmitted = false;                  //a frame waits for the output thread
+bool ledPipelineDriverDone = false;                 //the output thread finished a frame
+#endif
+#endif
+
+//Local Prototypes
+void RunLEDPipelineDriver();
+
+//Calls the driver on the front buffer, timed
+void RunLEDPipelineDriver()
+{
+    unsigned long start = micros();
+
+    ledPipelineDriver(ledPipelineBuffers[ledPipelineFront], LED_NUM_LEDS);
+
+    ledPipelineDriverTime = micros() - start;
+}
+
+#if LED_PIPELINE_ENABLED
+#ifdef ESP32
+//Output task: one driver call per notification
+void LEDPipelineTask(void *parameters)
+{
+    for (;;)
+    {
+        ulTaskNotifyTake(pdTRUE, portMAX_DELAY);
+        RunLEDPipelineDriver();
+        xSemaphoreGive(ledPipelineDone);
+    }
+}
+#else
+//Output thread (host): one driver call per submitted frame
+void LEDPipelineThread()
+{
+    std::unique_lock<std::mutex> lock(*ledPipelineMutex);
+
+    for (;;)
+    {
+        ledPipelineSignal->wait(lock, [] { return ledPipelineSubmitted; });
+        ledPipelineSubmitted = false;
+
+        lock.unlock();
+        RunLEDPipelineDriver();
+        lock.lock();
+
+        ledPipelineDriverDone = true;
+        ledPipelineSignal->notify_all();
+    }
+}
+#endif
+#endif
+
+//Starts the output task handing frames to the driver
+void InitLEDPipeline(LedPipelineDriver driver)
+{
+    if (ledPipelineDriver != NULL)
+        return;
+
+    ledPipelineDriver = driver;
+
+    #if LED_PIPELINE_ENABLED
+        #ifdef ESP32
+            ledPipelineDone = xSemaphoreCreateBinary();
+
+            //above loop(): the task only runs to start the transfer, then waits on the driver
+            xTaskCreatePinnedToCore(LEDPipelineTask, "LEDOutput", 3072, NULL, LED_PIPELINE_PRIORITY, &ledPipelineTask, LED_PIPELINE_CORE);
+        #else
+            ledPipelineMutex = new std::mutex();
+            ledPipelineSignal = new std::condition_variable();
+            std::thread(LEDPipelineThread).detach();
+        #endif
+    #endif
+}
+
+//Gets the buffer the next frame is written into, never read by the driver
+CRGB *GetLEDPipelineBackBuffer()
+{
+    return ledPipelineBuffers[1 - ledPipelineFront];
+}
+
+//Gets the buffer of the last frame handed to the driver (read only)
+const CRGB *GetLEDPipelineFrontBuffer()
+{
+    return ledPipelineBuffers[ledPipelineFront];
+}
+
+//Waits until the driver is done with the last frame handed to it
+void WaitLEDPipeline()
+{
+    if (!ledPipelineBusy)
+        return;
+
+    TRACE_SCOPE("WaitLEDPipeline");
+
+    unsigned long start = micros();
+
+    #if LED_PIPELINE_ENABLED
+        #ifdef ESP32
+            xSemaphoreTake(ledPipelineDone, portMAX_DELAY);
+        #else
+            std::unique_lock<std::mutex> lock(*ledPipelineMutex);
+            ledPipelineSignal->wait(lock, [] { return ledPipelineDriverDone; });
+            ledPipelineDriverDone = false;
+        #endif
+    #endif
+
+    ledPipelineWaitTime += micros() - start;
+    ledPipelineBusy = false;
+}
+
+//Hands the back buffer to the driver and swaps the buffers, waits for the previous frame first
+void SubmitLEDPipelineFrame()
+{
+    //fence: the driver must be done with the front buffer before it becomes the back one
+    WaitLEDPipeline();
+
+    ledPipelineFront = 1 - ledPipelineFront;
+
+    //frames drawn before the output is initialized are not pushed
+    if (ledPipelineDriver == NULL)
+        return;
+
+    ledPipelineFrames++;
+
+    #if LED_PIPELINE_ENABLED
+        ledPipelineBusy = true;
+
+        #ifdef ESP32
+            xTaskNotifyGive(ledPipelineTask);
+        #else
+            std::lock_guard<std::mutex> lock(*ledPipelineMutex);
+            ledPipelineSubmitted = true;
+            ledPipelineSignal->notify_all();
+        #endif
+    #else
+        RunLEDPipelineDriver();
+    #endif
+}
+
+//Gets how many frames were handed to the driver
+unsigned long GetLEDPipelineFrames()
+{
+    return ledPipelineFrames;
+}
+
+//Gets the total time spent waiting for the driver in us
+unsigned long GetLEDPipelineWaitTime()
+{
+    return ledPipelineWaitTime;
+}
+
+//Gets how long the driver took for the last frame in us
+unsigned long GetLEDPipelineDriverTime()
+{
+    return ledPipelineDriverTime;
+}
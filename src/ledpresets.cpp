@@ -0,0 +1,118 @@
+//+--------------------------------------------------------------------------
+//
+// File:        ledpresets.cpp
+//
+// Description: The purpose of this file is to provide the table of built-in
+//              effect presets. Colour strings are decoded by the compiler
+//              (constexpr), so the table lives in flash and selecting a
+//              preset is a pointer assignment.
+//
+// History:     2026-10-18    PP Laplante   Created
+//
+//
+//---------------------------------------------------------------------------
+#include <string.h>
+#include <ledpresets.h>
+
+//Not constexpr on purpose: reaching it while evaluating a preset is a compile error
+void InvalidPresetColorString();
+
+//Converts one hexadecimal character at compile time
+constexpr uint32_t PresetHexNibble(char c)
+{
+    if (c >= '0' && c <= '9')
+        return c - '0';
+    if (c >= 'A' && c <= 'F')
+        return c - 'A' + 10;
+    if (c >= 'a' && c <= 'f')
+        return c - 'a' + 10;
+
+    InvalidPresetColorString();
+    return 0;
+}
+
+//Compiles RRGGBB hexadecimal text into a pattern at compile time (same layout as CompileLEDPattern)
+template <size_t N>
+constexpr LedPattern MakePresetPattern(const char (&hex)[N])
+{
+    LedPattern pattern = {};
+
+    //N includes the terminating zero
+    if ((N - 1) % 6 != 0 || (N - 1) / 6 > LED_PATTERN_MAX_LENGTH)
+        InvalidPresetColorString();
+
+    for (size_t i = 0; i < (N - 1) / 6; i++)
+    {
+        uint32_t color = 0;
+        for (size_t k = 0; k < 6; k++)
+            color = (color << 4) | PresetHexNibble(hex[i*6 + k]);
+
+        //find colour in palette, add it if new
+        size_t index = 0;
+        while (index < pattern.paletteSize && pattern.palette[index] != color)
+            index++;
+
+        if (index == pattern.paletteSize)
+        {
+            if (pattern.paletteSize == LED_PATTERN_MAX_COLORS)
+                InvalidPresetColorString();
+
+            pattern.palette[pattern.paletteSize++] = color;
+        }
+
+        pattern.indexes[i] = index;
+        pattern.length++;
+    }
+
+    return pattern;
+}
+
+//Built-in presets
+constexpr LedPreset ledPresets[] =
+{
+    { "northpole",  LED_PRESET_PATTERN, MakePresetPattern("FF0000000000000000FFFFFF000000000000"), 1.0f, -1 },
+    { "quebec",     LED_PRESET_PATTERN, MakePresetPattern("0000FF000000000000FFFFFF000000000000"), 1.0f, -1 },
+    //bleu orange vert roughe jaune
+    { "festive",    LED_PRESET_PATTERN, MakePresetPattern("0000FF00000000000000FF000000000000000000FF000000000000F3E220000000000000FF0000000000000000"), 1.0f, -1 },
+};
+
+//Gets the number of built-in presets
+int GetLEDPresetCount()
+{
+    return sizeof(ledPresets) / sizeof(ledPresets[0]);
+}
+
+//Gets a built-in preset by index, NULL if out of range
+const LedPreset *GetLEDPreset(int index)
+{
+    if (index < 0 || index >= GetLEDPresetCount())
+        return NULL;
+
+    return &ledPresets[index];
+}
+
+//Finds a built-in preset by name, NULL if not found
+const LedPreset *FindLEDPreset(const char *name)
+{
+    for (int i = 0; i < GetLEDPresetCount(); i++)
+    {
+        if (strcmp(ledPresets[i].name, name) == 0)
+            return &ledPresets[i];
+    }
+
+    return NULL;
+}
+
+//Gets the name of a preset type as used by /api/presets
+const char *GetLEDPresetTypeName(LedPresetType type)
+{
+    switch (type)
+    {
+        case LED_PRESET_PATTERN:    return "pattern";
+        case LED_PRESET_SOLID:      return "solid";
+        case LED_PRESET_BEAT:       return "beat";
+        case LED_PRESET_RAINBOW:    return "rainbow";
+    }
+
+    return "";
+}
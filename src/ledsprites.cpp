@@ -0,0 +1,452 @@
+//+--------------------------------------------------------------------------
+//
+// File:        ledsprites.cpp
+//
+// Description: The purpose of this file is to provide small sprites moving
+//              over the displayed effect. Sprite images come from the image
+//              store, are cropped to their opaque pixels and keep per row
+//              spans of them, so a blit only touches the pixels it covers.
+//              Sprites are drawn in z order on their own layer, which is
+//              only redrawn when a sprite actually moved on screen.
+//
+// History:     2026-10-18    PP Laplante   Created
+//
+//
+//---------------------------------------------------------------------------
+#include <Arduino.h>
+#include <ArduinoJson.h>
+#include <FastLED.h>
+#include <traceutils.h>
+#include <logutils.h>
+#include <ledconfig.h>
+#include <ledimage.h>
+#include <ledlayers.h>
+#include <ledsprites.h>
+
+#define LED_SPRITE_MAX_SPEED    4096.0f     //pixels per second, keeps velocity * 1000 ms within 32 bits
+
+struct LedSpriteImage
+{
+    char        name[32];                           //empty when the slot is free
+    uint8_t     width;
+    uint8_t     height;
+    CRGB        key;                                //transparent colour
+    CRGB        pixels[LED_SPRITE_MAX_PIXELS];      //cropped image, row order
+    uint8_t     spanStart[LED_SPRITE_MAX_PIXELS];   //first opaque column of each row
+    uint8_t     spanEnd[LED_SPRITE_MAX_PIXELS];     //last opaque column + 1, equal to start if the row is empty
+};
+
+struct LedSprite
+{
+    int8_t          image = -1;                     //-1 when the sprite is free
+    int8_t          z;
+    bool            visible;
+    LedSpriteEdge   edge;
+    int32_t         x;                              //position, 8.8 fixed point
+    int32_t         y;
+    int32_t         vx;                             //velocity in pixels per second, 8.8 fixed point
+    int32_t         vy;
+    int16_t         restX;                          //move left over from the last update, 1/1000 of a position step
+    int16_t         restY;
+    int16_t         drawnX;                         //position on screen at the last redraw
+    int16_t         drawnY;
+};
+
+//Global variables
+LedSpriteImage ledSpriteImages[LED_SPRITE_IMAGES];  //loaded images
+LedSprite ledSprites[LED_SPRITE_MAX];               //sprites, unordered
+bool ledSpritesDirty = false;                       //sprite layer must be redrawn
+unsigned long ledSpritesUpdated = 0;                //time of the last update
+
+const char *ledSpriteEdgeNames[] = { "wrap", "bounce", "stop" };
+
+//Local Prototypes
+void DrawLEDSprites();
+void MoveLEDSpriteAxis(int32_t &pos, int32_t &velocity, int size, int limit, LedSpriteEdge edge);
+
+//Validates a sprite id
+static inline bool IsLEDSprite(int sprite)
+{
+    return sprite >= 0 && sprite < LED_SPRITE_MAX && ledSprites[sprite].image >= 0;
+}
+
+//Gets the sprite image loaded under a name, -1 if not loaded
+int FindLEDSpriteImage(const char *name)
+{
+    for (int i = 0; i < LED_SPRITE_IMAGES; i++)
+        if (ledSpriteImages[i].name[0] != '\0' && strncmp(ledSpriteImages[i].name, name, sizeof(ledSpriteImages[i].name) - 1) == 0)
+            return i;
+
+    return -1;
+}
+
+//Loads a sprite image (image store format), cropping the borders of the transparent key colour
+int LoadLEDSpriteImage(const char *name, const String &data, CRGB key)
+{
+    TRACE_SCOPE("LoadLEDSpriteImage");
+
+    //reuse the slot of the same name, or take a free one
+    int slot = FindLEDSpriteImage(name);
+    for (int i = 0; i < LED_SPRITE_IMAGES && slot < 0; i++)
+        if (ledSpriteImages[i].name[0] == '\0')
+            slot = i;
+
+    if (slot < 0)
+    {
+        LOG_WARN("No free sprite image slot for %s", name);
+        return -1;
+    }
+
+    //decode at full size in a temporary buffer, sized from the header (stored images are usually compressed)
+    size_t capacity = GetLEDImagePixelCount(data.c_str(), data.length());
+    if (capacity == 0)
+    {
+        LOG_WARN("Invalid sprite image %s", name);
+        return -1;
+    }
+
+    CRGB *decoded = (CRGB *) malloc(capacity * sizeof(CRGB));
+    if (decoded == NULL)
+        return -1;
+
+    LedImage image = { 0, 0, decoded };
+    int errorPos = 0;
+    if (!DecodeLEDImage(data.c_str(), data.length(), image, capacity, &errorPos))
+    {
+        LOG_WARN("Invalid sprite image %s at position %d", name, errorPos);
+        free(decoded);
+        return -1;
+    }
+
+    //bounding box of the opaque pixels
+    int left = image.width, right = -1, top = image.height, bottom = -1;
+    for (int y = 0; y < image.height; y++)
+        for (int x = 0; x < image.width; x++)
+            if (decoded[y * image.width + x] != key)
+            {
+                if (x < left) left = x;
+                if (x > right) right = x;
+                if (y < top) top = y;
+                if (y > bottom) bottom = y;
+            }
+
+    int width = right - left + 1;
+    int height = bottom - top + 1;
+
+    if (right < 0 || width > 255 || height > 255 || width * height > LED_SPRITE_MAX_PIXELS)
+    {
+        LOG_WARN("Sprite image %s is empty or larger than %d pixels", name, LED_SPRITE_MAX_PIXELS);
+        free(decoded);
+        return -1;
+    }
+
+    LedSpriteImage &s = ledSpriteImages[slot];
+    strncpy(s.name, name, sizeof(s.name) - 1);
+    s.name[sizeof(s.name) - 1] = '\0';
+    s.width = width;
+    s.height = height;
+    s.key = key;
+
+    for (int y = 0; y < height; y++)
+    {
+        const CRGB *row = decoded + (top + y) * image.width + left;
+        int start = width, end = 0;
+
+        for (int x = 0; x < width; x++)
+        {
+            s.pixels[y * width + x] = row[x];
+            if (row[x] != key)
+            {
+                if (x < start) start = x;
+                end = x + 1;
+            }
+        }
+
+        s.spanStart[y] = (start < end) ? start : 0;
+        s.spanEnd[y] = (start < end) ? end : 0;
+    }
+
+    free(decoded);
+    ledSpritesDirty = true;
+
+    LOG_DEBUG("Sprite image %s loaded in slot %d (%dx%d)", name, slot, width, height);
+
+    return slot;
+}
+
+//Places a new sprite, higher z is drawn on top, returns the sprite id or -1 if full
+int AddLEDSprite(int image, int x, int y, int z)
+{
+    if (image < 0 || image >= LED_SPRITE_IMAGES || ledSpriteImages[image].name[0] == '\0')
+        return -1;
+
+    for (int i = 0; i < LED_SPRITE_MAX; i++)
+    {
+        if (ledSprites[i].image >= 0)
+            continue;
+
+        LedSprite &s = ledSprites[i];
+        s.image = image;
+        s.z = z;
+        s.visible = true;
+        s.edge = LED_SPRITE_WRAP;
+        s.x = x * 256;
+        s.y = y * 256;
+        s.vx = s.vy = 0;
+        s.restX = s.restY = 0;
+        ledSpritesDirty = true;
+
+        return i;
+    }
+
+    return -1;
+}
+
+//Removes a sprite
+void RemoveLEDSprite(int sprite)
+{
+    if (!IsLEDSprite(sprite))
+        return;
+
+    ledSprites[sprite].image = -1;
+    ledSpritesDirty = true;
+}
+
+//Removes all sprites and unloads their images
+void ClearLEDSprites()
+{
+    for (int i = 0; i < LED_SPRITE_MAX; i++)
+        ledSprites[i].image = -1;
+
+    for (int i = 0; i < LED_SPRITE_IMAGES; i++)
+        ledSpriteImages[i].name[0] = '\0';
+
+    ledSpritesDirty = true;
+}
+
+//Moves a sprite (top left corner of its cropped image)
+void MoveLEDSprite(int sprite, int x, int y)
+{
+    if (!IsLEDSprite(sprite))
+        return;
+
+    ledSprites[sprite].x = x * 256;
+    ledSprites[sprite].y = y * 256;
+    ledSprites[sprite].restX = ledSprites[sprite].restY = 0;
+    ledSpritesDirty = true;
+}
+
+//Sets the velocity of a sprite in pixels per second
+void SetLEDSpriteVelocity(int sprite, float vx, float vy)
+{
+    if (!IsLEDSprite(sprite))
+        return;
+
+    ledSprites[sprite].vx = (int32_t) (constrain(vx, -LED_SPRITE_MAX_SPEED, LED_SPRITE_MAX_SPEED) * 256.0f);
+    ledSprites[sprite].vy = (int32_t) (constrain(vy, -LED_SPRITE_MAX_SPEED, LED_SPRITE_MAX_SPEED) * 256.0f);
+}
+
+//Sets what a sprite does at the edge of the matrix
+void SetLEDSpriteEdge(int sprite, LedSpriteEdge edge)
+{
+    if (IsLEDSprite(sprite))
+        ledSprites[sprite].edge = edge;
+}
+
+//Sets the drawing order of a sprite, higher is on top
+void SetLEDSpriteZ(int sprite, int z)
+{
+    if (!IsLEDSprite(sprite))
+        return;
+
+    ledSprites[sprite].z = z;
+    ledSpritesDirty = true;
+}
+
+//Shows or hides a sprite
+void SetLEDSpriteVisible(int sprite, bool visible)
+{
+    if (!IsLEDSprite(sprite))
+        return;
+
+    ledSprites[sprite].visible = visible;
+    ledSpritesDirty = true;
+}
+
+//Advances one coordinate, applying the edge behaviour
+void MoveLEDSpriteAxis(int32_t &pos, int32_t &velocity, int size, int limit, LedSpriteEdge edge)
+{
+    int32_t low = 0;
+    int32_t high = (int32_t) (limit - size) << 8;
+
+    if (edge == LED_SPRITE_WRAP)
+    {
+        //fully off screen on one side, back in on the other
+        int32_t span = (int32_t) (limit + size) << 8;
+        low = -((int32_t) size << 8);
+        if (pos < low)
+            pos += span;
+        else if (pos >= (int32_t) limit << 8)
+            pos -= span;
+    }
+    else if (pos < low || pos > high)
+    {
+        pos = (pos < low) ? low : high;
+
+        if (edge == LED_SPRITE_BOUNCE)
+            velocity = (pos == low) ? abs(velocity) : -abs(velocity);
+        else
+            velocity = 0;
+    }
+}
+
+//Moves the sprites and redraws the sprite layer if anything visible changed - to be called every frame
+void UpdateLEDSprites(unsigned long now)
+{
+    unsigned long elapsed = now - ledSpritesUpdated;
+    ledSpritesUpdated = now;
+
+    //a long pause (effect change, stall) would make sprites jump
+    if (elapsed > 1000)
+        elapsed = 0;
+
+    for (int i = 0; i < LED_SPRITE_MAX; i++)
+    {
+        LedSprite &s = ledSprites[i];
+        if (s.image < 0 || (s.vx == 0 && s.vy == 0))
+            continue;
+
+        const LedSpriteImage &image = ledSpriteImages[s.image];
+
+        //the part of a position step not reached yet is carried over, slow sprites at high frame rates still move
+        int32_t moveX = s.vx * (int32_t) elapsed + s.restX;
+        int32_t moveY = s.vy * (int32_t) elapsed + s.restY;
+        s.x += moveX / 1000;
+        s.y += moveY / 1000;
+        s.restX = moveX % 1000;
+        s.restY = moveY % 1000;
+
+        MoveLEDSpriteAxis(s.x, s.vx, image.width, LED_MATRIX_WIDTH, s.edge);
+        MoveLEDSpriteAxis(s.y, s.vy, image.height, LED_MATRIX_HEIGHT, s.edge);
+
+        //sub pixel moves do not need a redraw
+        if (s.visible && ((s.x >> 8) != s.drawnX || (s.y >> 8) != s.drawnY))
+            ledSpritesDirty = true;
+    }
+
+    if (ledSpritesDirty)
+        DrawLEDSprites();
+}
+
+//Redraws the sprite layer, lowest z first
+void DrawLEDSprites()
+{
+    TRACE_SCOPE("DrawLEDSprites");
+
+    ledSpritesDirty = false;
+    ClearLEDLayer(LED_LAYER_SPRITES);
+
+    //sort the visible sprites by z (insertion sort, the list is short)
+    int order[LED_SPRITE_MAX];
+    int count = 0;
+    for (int i = 0; i < LED_SPRITE_MAX; i++)
+    {
+        if (ledSprites[i].image < 0 || !ledSprites[i].visible)
+            continue;
+
+        int j = count++;
+        while (j > 0 && ledSprites[order[j - 1]].z > ledSprites[i].z)
+        {
+            order[j] = order[j - 1];
+            j--;
+        }
+        order[j] = i;
+    }
+
+    for (int n = 0; n < count; n++)
+    {
+        LedSprite &s = ledSprites[order[n]];
+        const LedSpriteImage &image = ledSpriteImages[s.image];
+
+        int px = s.x >> 8;
+        int py = s.y >> 8;
+        s.drawnX = px;
+        s.drawnY = py;
+
+        //clip the rows, then each row span, to the matrix
+        int firstRow = (py < 0) ? -py : 0;
+        int lastRow = (py + image.height > LED_MATRIX_HEIGHT) ? LED_MATRIX_HEIGHT - py : image.height;
+
+        for (int r = firstRow; r < lastRow; r++)
+        {
+            int start = image.spanStart[r];
+            int end = image.spanEnd[r];
+            if (px + start < 0)
+                start = -px;
+            if (px + end > LED_MATRIX_WIDTH)
+                end = LED_MATRIX_WIDTH - px;
+
+            const CRGB *row = image.pixels + r * image.width;
+            for (int c = start; c < end; c++)
+                if (row[c] != image.key)
+                    SetLEDLayerPixel(LED_LAYER_SPRITES, px + c, py + r, row[c]);
+        }
+    }
+}
+
+//Gets the edge behaviour matching a name (wrap, bounce, stop), wrap if unknown
+LedSpriteEdge ParseLEDSpriteEdge(String name)
+{
+    name.trim();
+    name.toLowerCase();
+
+    for (int i = 0; i < (int) (sizeof(ledSpriteEdgeNames) / sizeof(ledSpriteEdgeNames[0])); i++)
+        if (name == ledSpriteEdgeNames[i])
+            return (LedSpriteEdge) i;
+
+    return LED_SPRITE_WRAP;
+}
+
+//Gets the sprites and loaded images as JSON
+String SerializeLEDSprites()
+{
+    String info = "";
+    DynamicJsonDocument doc(4096);
+
+    JsonArray images = doc.createNestedArray("images");
+    for (int i = 0; i < LED_SPRITE_IMAGES; i++)
+    {
+        const LedSpriteImage &image = ledSpriteImages[i];
+        if (image.name[0] == '\0')
+            continue;
+
+        JsonObject o = images.createNestedObject();
+        o["slot"] = i;
+        o["name"] = image.name;
+        o["width"] = image.width;
+        o["height"] = image.height;
+    }
+
+    JsonArray sprites = doc.createNestedArray("sprites");
+    for (int i = 0; i < LED_SPRITE_MAX; i++)
+    {
+        const LedSprite &s = ledSprites[i];
+        if (s.image < 0)
+            continue;
+
+        JsonObject o = sprites.createNestedObject();
+        o["id"] = i;
+        o["image"] = ledSpriteImages[s.image].name;
+        o["x"] = s.x >> 8;
+        o["y"] = s.y >> 8;
+        o["z"] = s.z;
+        o["vx"] = s.vx / 256.0f;
+        o["vy"] = s.vy / 256.0f;
+        o["edge"] = ledSpriteEdgeNames[s.edge];
+        o["visible"] = s.visible;
+    }
+
+    serializeJson(doc, info);
+
+    return info;
+}
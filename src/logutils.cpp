@@ -0,0 +1,318 @@
+//+--------------------------------------------------------------------------
+//
+// File:        logutils.cpp
+//
+// Description: The purpose of this file is to provide leveled, non blocking
+//              logging. Messages are formatted into a lock-free ring buffer
+//              and written to the serial port by a low priority task, so
+//              the render path never waits on the UART. Each level has a
+//              token bucket: a message repeated every frame is limited to
+//              LOG_RATE_PER_SECOND instead of filling the queue and pushing
+//              out the messages of the other levels.
+//
+// History:     2026-10-18    PP Laplante   Created
+//
+//
+//---------------------------------------------------------------------------
+#include <Arduino.h>
+#include <stdarg.h>
+#include <atomic>
+#include <logutils.h>
+
+static_assert((LOG_QUEUE_SIZE & (LOG_QUEUE_SIZE - 1)) == 0, "LOG_QUEUE_SIZE must be a power of 2");
+static_assert(LOG_RATE_BURST >= 1 && LOG_RATE_BURST < 1024, "LOG_RATE_BURST must fit the token bits");
+
+#define LOG_FLAG_NEWLINE        0x01
+#define LOG_FLAG_PREFIX         0x02
+
+//Token bucket state packed in 32 bits, updated with a single compare and swap:
+//time of the last refill (ms, low 22 bits) and tokens left (10 bits)
+#define LOG_RATE_TOKEN_BITS     10
+#define LOG_RATE_TOKEN_MASK     ((1u << LOG_RATE_TOKEN_BITS) - 1)
+#define LOG_RATE_TIME_MASK      ((1u << (32 - LOG_RATE_TOKEN_BITS)) - 1)
+
+//Bounded multi-producer queue slot (sequence number tells who owns the slot)
+struct LogSlot
+{
+    std::atomic<uint32_t>   sequence;
+    uint8_t                 level;
+    uint8_t                 flags;
+    char                    text[LOG_LINE_LENGTH];
+};
+
+const char logLevelTags[] = { ' ', 'E', 'W', 'I', 'D' };
+
+//Global variables
+LogSlot logQueue[LOG_QUEUE_SIZE];                   //ring buffer
+std::atomic<uint32_t> logEnqueuePos(0);             //next position to reserve
+uint32_t logDequeuePos = 0;                         //next position to drain (drain task only)
+std::atomic<unsigned long> logDropped(0);           //lines lost because the queue was full
+std::atomic<uint32_t> logRate[LOG_LEVEL_DEBUG + 1];  //token bucket per level, see LOG_RATE_TOKEN_BITS
+std::atomic<unsigned long> logThrottled(0);         //lines lost because their level was over its rate
+TaskHandle_t logTaskHandle = NULL;                  //drain task
+
+char logTail[LOG_TAIL_LINES][LOG_LINE_LENGTH];      //last lines written
+int logTailNext = 0;                                //line being written
+int logTailCount = 0;                               //number of complete lines
+int logTailPos = 0;                                 //position in line being written
+SemaphoreHandle_t logTailMutex = NULL;              //guards tail against the HTTP reader
+
+//Local Prototypes
+void LogDrainTask(void *parameters);
+void LogAppendTail(const char *text, bool newline);
+
+//Starts the background task draining the log to the serial port
+void InitLog()
+{
+    if (logTaskHandle != NULL)
+        return;
+
+    for (uint32_t i = 0; i < LOG_QUEUE_SIZE; i++)
+        logQueue[i].sequence.store(i, std::memory_order_relaxed);
+
+    //every level starts with a full burst
+    uint32_t now = millis() & LOG_RATE_TIME_MASK;
+    for (int level = 0; level <= LOG_LEVEL_DEBUG; level++)
+        logRate[level].store((now << LOG_RATE_TOKEN_BITS) | LOG_RATE_BURST, std::memory_order_relaxed);
+
+    logTailMutex = xSemaphoreCreateMutex();
+
+    //lowest useful priority, on the core not running loop()
+    xTaskCreatePinnedToCore(LogDrainTask, "LogDrain", 3072, NULL, 1, &logTaskHandle, 0);
+}
+
+//Reserves a slot, returns NULL when the queue is full or not started yet
+LogSlot *LogReserve(uint32_t &pos)
+{
+    if (logTaskHandle == NULL)
+        return NULL;
+
+    pos = logEnqueuePos.load(std::memory_order_relaxed);
+
+    for (;;)
+    {
+        LogSlot &slot = logQueue[pos % LOG_QUEUE_SIZE];
+        int32_t diff = (int32_t) (slot.sequence.load(std::memory_order_acquire) - pos);
+
+        if (diff == 0)
+        {
+            //slot is free, try to claim it
+            if (logEnqueuePos.compare_exchange_weak(pos, pos + 1, std::memory_order_relaxed))
+                return &slot;
+        }
+        else if (diff < 0)
+        {
+            //queue is full
+            logDropped++;
+            return NULL;
+        }
+        else
+        {
+            //another producer claimed it, retry
+            pos = logEnqueuePos.load(std::memory_order_relaxed);
+        }
+    }
+}
+
+//Takes a token from the bucket of a level, returns false when the level is over its rate
+bool LogTakeToken(int level)
+{
+    #if LOG_RATE_PER_SECOND > 0
+        if (level < 0 || level > LOG_LEVEL_DEBUG)
+            level = LOG_LEVEL_DEBUG;
+
+        std::atomic<uint32_t> &bucket = logRate[level];
+        uint32_t now = millis() & LOG_RATE_TIME_MASK;
+        uint32_t state = bucket.load(std::memory_order_relaxed);
+
+        for (;;)
+        {
+            uint32_t last = state >> LOG_RATE_TOKEN_BITS;
+            uint32_t tokens = state & LOG_RATE_TOKEN_MASK;
+            uint32_t elapsed = (now - last) & LOG_RATE_TIME_MASK;
+
+            //another task refilled after this one read the time
+            if (elapsed > LOG_RATE_TIME_MASK / 2)
+                elapsed = 0;
+
+            //refill whole tokens only, the time of a partial token is kept for the next message
+            uint32_t refill = (uint64_t) elapsed * LOG_RATE_PER_SECOND / 1000;
+            if (tokens + refill >= LOG_RATE_BURST)
+            {
+                tokens = LOG_RATE_BURST;
+                last = now;
+            }
+            else
+            {
+                tokens += refill;
+                last = (last + refill * 1000 / LOG_RATE_PER_SECOND) & LOG_RATE_TIME_MASK;
+            }
+
+            if (tokens == 0)
+            {
+                logThrottled++;
+                return false;
+            }
+
+            uint32_t next = (last << LOG_RATE_TOKEN_BITS) | (tokens - 1);
+            if (bucket.compare_exchange_weak(state, next, std::memory_order_relaxed))
+                return true;
+        }
+    #else
+        return true;
+    #endif
+}
+
+//Hands a filled slot to the drain task
+void LogPublish(LogSlot *slot, uint32_t pos)
+{
+    slot->sequence.store(pos + 1, std::memory_order_release);
+}
+
+//Formats a line into the log queue, never blocks (drops the line when full or over the rate of its level)
+bool LogPrintf(int level, const char *format, ...)
+{
+    if (logTaskHandle == NULL || !LogTakeToken(level))
+        return false;
+
+    uint32_t pos;
+    LogSlot *slot = LogReserve(pos);
+
+    if (slot == NULL)
+        return false;
+
+    va_list args;
+    va_start(args, format);
+    vsnprintf(slot->text, LOG_LINE_LENGTH, format, args);
+    va_end(args);
+
+    slot->level = level;
+    slot->flags = LOG_FLAG_NEWLINE | LOG_FLAG_PREFIX;
+    LogPublish(slot, pos);
+
+    return true;
+}
+
+//Queues raw text for the serial port, optionally terminating the line
+bool LogWrite(const char *text, bool newline)
+{
+    size_t remaining = strlen(text);
+
+    //split long text over several slots
+    do
+    {
+        uint32_t pos;
+        LogSlot *slot = LogReserve(pos);
+
+        if (slot == NULL)
+            return false;
+
+        size_t n = remaining < LOG_LINE_LENGTH - 1 ? remaining : LOG_LINE_LENGTH - 1;
+        memcpy(slot->text, text, n);
+        slot->text[n] = '\0';
+        text += n;
+        remaining -= n;
+
+        slot->level = LOG_LEVEL_INFO;
+        slot->flags = (remaining == 0 && newline) ? LOG_FLAG_NEWLINE : 0;
+        LogPublish(slot, pos);
+    } while (remaining > 0);
+
+    return true;
+}
+
+//Gets the number of messages dropped because the queue was full
+unsigned long GetLogDroppedCount()
+{
+    return logDropped.load();
+}
+
+//Gets the number of messages dropped because their level was over its rate
+unsigned long GetLogThrottledCount()
+{
+    return logThrottled.load();
+}
+
+//Gets the last lines written to the log, oldest first
+String GetLogTail(int lines)
+{
+    String ret = "";
+
+    if (logTailMutex == NULL)
+        return ret;
+
+    if (lines > logTailCount)
+        lines = logTailCount;
+
+    xSemaphoreTake(logTailMutex, portMAX_DELAY);
+
+    for (int i = lines; i > 0; i--)
+    {
+        ret += logTail[(logTailNext - i + LOG_TAIL_LINES) % LOG_TAIL_LINES];
+        ret += "\n";
+    }
+
+    xSemaphoreGive(logTailMutex);
+
+    return ret;
+}
+
+//Appends drained text to the tail history
+void LogAppendTail(const char *text, bool newline)
+{
+    xSemaphoreTake(logTailMutex, portMAX_DELAY);
+
+    char *line = logTail[logTailNext];
+    while (*text != '\0' && logTailPos < LOG_LINE_LENGTH - 1)
+        line[logTailPos++] = *text++;
+    line[logTailPos] = '\0';
+
+    if (newline)
+    {
+        logTailNext = (logTailNext + 1) % LOG_TAIL_LINES;
+        logTailPos = 0;
+        if (logTailCount < LOG_TAIL_LINES)
+            logTailCount++;
+    }
+
+    xSemaphoreGive(logTailMutex);
+}
+
+//Writes queued messages to the serial port
+void LogDrainTask(void *parameters)
+{
+    for (;;)
+    {
+        LogSlot &slot = logQueue[logDequeuePos % LOG_QUEUE_SIZE];
+        int32_t diff = (int32_t) (slot.sequence.load(std::memory_order_acquire) - (logDequeuePos + 1));
+
+        if (diff < 0)
+        {
+            //nothing to drain, let other tasks run
+            vTaskDelay(pdMS_TO_TICKS(10));
+            continue;
+        }
+
+        //blocking here only delays this task
+        bool newline = slot.flags & LOG_FLAG_NEWLINE;
+        char prefix[5] = "";
+        if (slot.flags & LOG_FLAG_PREFIX)
+            snprintf(prefix, sizeof(prefix), "[%c] ", logLevelTags[slot.level]);
+
+        if (Serial)
+        {
+            Serial.print(prefix);
+            if (newline)
+                Serial.println(slot.text);
+            else
+                Serial.print(slot.text);
+        }
+
+        LogAppendTail(prefix, false);
+        LogAppendTail(slot.text, newline);
+
+        //release the slot for the next lap
+        slot.sequence.store(logDequeuePos + LOG_QUEUE_SIZE, std::memory_order_release);
+        logDequeuePos++;
+    }
+}
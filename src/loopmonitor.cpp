@@ -0,0 +1,171 @@
+//+--------------------------------------------------------------------------
+//
+// File:        loopmonitor.cpp
+//
+// Description: The purpose of this file is to provide a watchdog style
+//              monitor of the main loop: each phase is timed, phases going
+//              over budget are counted, histogrammed and the last offenders
+//              are kept with the route that was being served.
+//
+// History:     2026-10-18    PP Laplante   Created
+//
+//
+//---------------------------------------------------------------------------
+#include <Arduino.h>
+#include <ArduinoJson.h>
+#include <arduinoutils.h>
+#include <traceutils.h>
+#include <loopmonitor.h>
+
+struct LoopPhaseStats
+{
+    unsigned long count = 0;                        //number of times the phase ran
+    unsigned long overruns = 0;                     //number of times it went over budget
+    unsigned long maxUs = 0;                        //longest duration seen
+    unsigned long histogram[LOOP_MONITOR_BUCKETS] = {};  //log2 buckets in ms
+};
+
+struct LoopOffender
+{
+    LoopPhase       phase;
+    unsigned long   durationUs;
+    unsigned long   timestampMs;
+    char            route[32];
+};
+
+//Phase names, also used as trace event names
+const char *loopPhaseNames[LOOP_PHASE_COUNT] = { "HandleClientRequests", "HandleShowcaseMode", "DrawLEDFrame" };
+
+//Global variables
+unsigned long loopBudgetUs = LOOP_MONITOR_DEFAULT_BUDGET_MS * 1000UL;  //budget per phase
+unsigned long loopPhaseStart[LOOP_PHASE_COUNT];                         //start time of running phases
+LoopPhaseStats loopStats[LOOP_PHASE_COUNT];                             //per phase statistics
+LoopOffender loopOffenders[LOOP_MONITOR_OFFENDERS];                     //ring of last offenders
+int loopOffenderCount = 0;                                              //number of valid offenders
+int loopOffenderNext = 0;                                               //next offender slot
+
+//Marks the start of a loop phase
+void LoopPhaseBegin(LoopPhase phase)
+{
+    TRACE_BEGIN(loopPhaseNames[phase]);
+
+    loopPhaseStart[phase] = micros();
+}
+
+//Marks the end of a loop phase, returns true if the phase exceeded the budget
+bool LoopPhaseEnd(LoopPhase phase)
+{
+    unsigned long durationUs = micros() - loopPhaseStart[phase];
+
+    TRACE_END(loopPhaseNames[phase]);
+
+    LoopPhaseStats &stats = loopStats[phase];
+    stats.count++;
+    if (durationUs > stats.maxUs)
+        stats.maxUs = durationUs;
+
+    //find log2 bucket of the duration in ms
+    unsigned long ms = durationUs / 1000;
+    int bucket = 0;
+    while (ms > 0 && bucket < LOOP_MONITOR_BUCKETS - 1)
+    {
+        ms >>= 1;
+        bucket++;
+    }
+    stats.histogram[bucket]++;
+
+    if (durationUs <= loopBudgetUs)
+        return false;
+
+    //record offender
+    stats.overruns++;
+
+    LoopOffender &offender = loopOffenders[loopOffenderNext];
+    offender.phase = phase;
+    offender.durationUs = durationUs;
+    offender.timestampMs = millis();
+    offender.route[0] = '\0';
+
+    loopOffenderNext = (loopOffenderNext + 1) % LOOP_MONITOR_OFFENDERS;
+    if (loopOffenderCount < LOOP_MONITOR_OFFENDERS)
+        loopOffenderCount++;
+
+    PrintlnSerial("Loop stall: " + String(loopPhaseNames[phase]) + " took " + String(durationUs / 1000) + "ms");
+
+    return true;
+}
+
+//Attaches the route being served to the most recent offender record
+void SetLoopOffenderRoute(String route)
+{
+    if (loopOffenderCount == 0)
+        return;
+
+    int last = (loopOffenderNext - 1 + LOOP_MONITOR_OFFENDERS) % LOOP_MONITOR_OFFENDERS;
+    route.toCharArray(loopOffenders[last].route, sizeof(loopOffenders[last].route));
+}
+
+//Sets the time budget of a single loop phase in milliseconds
+void SetLoopMonitorBudget(unsigned long budget_ms)
+{
+    //a budget of 0 would flag every phase
+    if (budget_ms == 0)
+        budget_ms = LOOP_MONITOR_DEFAULT_BUDGET_MS;
+
+    loopBudgetUs = budget_ms * 1000UL;
+}
+
+//Gets the time budget of a single loop phase in milliseconds
+unsigned long GetLoopMonitorBudget()
+{
+    return loopBudgetUs / 1000UL;
+}
+
+//Clears histograms and offender records
+void ResetLoopMonitor()
+{
+    for (int i = 0; i < LOOP_PHASE_COUNT; i++)
+        loopStats[i] = LoopPhaseStats();
+
+    loopOffenderCount = 0;
+    loopOffenderNext = 0;
+}
+
+//Gets the phase statistics and offender records as JSON
+String SerializeLoopMonitor()
+{
+    String info = "";
+    StaticJsonDocument<2048> doc;
+
+    doc["budget_ms"] = GetLoopMonitorBudget();
+
+    JsonArray phases = doc.createNestedArray("phases");
+    for (int i = 0; i < LOOP_PHASE_COUNT; i++)
+    {
+        JsonObject phase = phases.createNestedObject();
+        phase["name"] = loopPhaseNames[i];
+        phase["count"] = loopStats[i].count;
+        phase["overruns"] = loopStats[i].overruns;
+        phase["max_us"] = loopStats[i].maxUs;
+
+        JsonArray histogram = phase.createNestedArray("histogram_log2_ms");
+        for (int b = 0; b < LOOP_MONITOR_BUCKETS; b++)
+            histogram.add(loopStats[i].histogram[b]);
+    }
+
+    //most recent offender first
+    JsonArray offenders = doc.createNestedArray("offenders");
+    for (int i = 1; i <= loopOffenderCount; i++)
+    {
+        const LoopOffender &o = loopOffenders[(loopOffenderNext - i + LOOP_MONITOR_OFFENDERS) % LOOP_MONITOR_OFFENDERS];
+        JsonObject offender = offenders.createNestedObject();
+        offender["phase"] = loopPhaseNames[o.phase];
+        offender["route"] = o.route;
+        offender["duration_us"] = o.durationUs;
+        offender["at_ms"] = o.timestampMs;
+    }
+
+    serializeJson(doc, info);
+
+    return info;
+}
@@ -24,15 +24,13 @@
 //----------------------------------------------------------------------------------------------
 
 // Global Constants
-#define LED_MATRIX_WIDTH        16
-#define LED_MATRIX_HEIGHT       16
-#define LED_NUM_LEDS            (MATRIX_WIDTH*MATRIX_HEIGHT)
-#define LED_MATRIX_INTERLACED   1
-#define LED_GPIO_PIN            13
 #define BOARD_PIN_LED           2
 #define WIFIUTILS_SERVERPORT    80
 #define LED_DEFAULT_EFFECT      "SHOWCASE"
 #define LED_DEFAULT_SHOWCASE    false
+#define LED_DEFAULT_TEXT_SPEED  0.15f
+#define LED_DEFAULT_LIFE_SPEED  0.1f
+#define LED_DEFAULT_FX_SPEED    1.0f
 
 #define CONFIG_FILE             "/config.json"
 #define IMAGE_DIR               "/images/"
@@ -51,6 +49,18 @@
 #include <fileutils.h>
 #include <ArduinoJson.h>
 #include <NtpHelper.h>
+#include <traceutils.h>
+#include <loopmonitor.h>
+#include <logutils.h>
+#include <ledpresets.h>
+#include <ledoutput.h>
+#include <ledpipeline.h>
+#include <ledgovernor.h>
+#include <ledlayers.h>
+#include <ledclock.h>
+#include <ledsprites.h>
+#include <ledanim.h>
+#include <ledimage.h>
 #include <version.h>
 
 struct LedManagerConfiguration
@@ -60,6 +70,16 @@ struct LedManagerConfiguration
     int     wifiTimeout = 60000;
     String  wifiHostname = "PIXELART";
     String  effectDefault = "DEFAULT";
+    unsigned long monitorBudget = LOOP_MONITOR_DEFAULT_BUDGET_MS;
+    float   outputGamma = LED_OUTPUT_GAMMA;
+    String  outputCorrection = String(LED_OUTPUT_CORRECTION, HEX);
+    unsigned long powerLimit = LED_POWER_LIMIT_MA;
+    String  imageMode = "nearest";
+    String  timeServer = "time.nrc.ca";
+    String  timeZone = NTP_DEFAULT_TIMEZONE;
+    bool    clockEnabled = false;
+    bool    clockSeconds = false;
+    String  clockColor = "FFFFFF";
 };
 
 struct DeviceInformation
@@ -104,11 +124,26 @@ void HandleShowcaseMode();
 void HandleSetConfig();
 void HandleGetConfig();
 void HandleConfigPage();
-void ActivateEffect(String effect, String color="", String brightness="", String imgname="");
+void ActivateEffect(String effect, String color="", String brightness="", String imgname="", String text="");
 void HandleReboot();
 void HandleGetInfo();
 void UpdateDeviceInfo();
 String SerializeDeviceInfo();
+void HandleGetTrace();
+void HandleSetTrace();
+void HandleGetMonitor();
+void HandleSetMonitor();
+void HandleGetLog();
+void HandleGetPresets();
+void ApplyPreset(const LedPreset *preset);
+String SerializePresets();
+void HandleGetOverlay();
+void HandleSetOverlay();
+void UpdateStatusOverlay();
+void HandleSetClock();
+void HandleClock();
+void HandleGetSprites();
+void HandleSetSprite();
 
 void setup() {
     //initialize pins
@@ -134,7 +169,7 @@ void setup() {
     //check if we are successfully connected to the WiFi (and hopefully internet)
     if (_server.IsWiFiConnected())
     {
-        _timeLord.ConfigNTP("time.nrc.ca");
+        _timeLord.ConfigNTP(_config.timeServer, "time1.google.com", "pool.ntp.org", _config.timeZone);
         PrintSerial("Current time is: ");
         PrintlnSerial(_timeLord.GetDateTime());
     }
@@ -186,6 +221,22 @@ void setup() {
     _server.WServer.on("/api/config", HTTP_GET, HandleGetConfig);
     _server.WServer.on("/api/reboot", HandleReboot);
     _server.WServer.on("/api/info", HandleGetInfo);
+    _server.WServer.on("/api/trace", HTTP_GET, HandleGetTrace);
+    _server.WServer.on("/api/trace", HTTP_PUT, HandleSetTrace);
+    _server.WServer.on("/api/trace", HTTP_POST, HandleSetTrace);
+    _server.WServer.on("/api/monitor", HTTP_GET, HandleGetMonitor);
+    _server.WServer.on("/api/monitor", HTTP_PUT, HandleSetMonitor);
+    _server.WServer.on("/api/monitor", HTTP_POST, HandleSetMonitor);
+    _server.WServer.on("/api/log", HTTP_GET, HandleGetLog);
+    _server.WServer.on("/api/presets", HTTP_GET, HandleGetPresets);
+    _server.WServer.on("/api/overlay", HTTP_GET, HandleGetOverlay);
+    _server.WServer.on("/api/overlay", HTTP_PUT, HandleSetOverlay);
+    _server.WServer.on("/api/overlay", HTTP_POST, HandleSetOverlay);
+    _server.WServer.on("/api/clock", HTTP_PUT, HandleSetClock);
+    _server.WServer.on("/api/clock", HTTP_POST, HandleSetClock);
+    _server.WServer.on("/api/sprite", HTTP_GET, HandleGetSprites);
+    _server.WServer.on("/api/sprite", HTTP_PUT, HandleSetSprite);
+    _server.WServer.on("/api/sprite", HTTP_POST, HandleSetSprite);
 
 
     //https://techtutorialsx.com/2018/10/12/esp32-http-web-server-handling-body-data/
@@ -196,6 +247,16 @@ void setup() {
     //Initialize LEDs
     InitLED();
 
+    //read only images straight from flash, when the partition table has an image pack
+    #if LED_IMAGE_PACK
+        ImagePack imagePack;
+        if (MapImagePackPartition(imagePack))
+        {
+            SetLEDImagePack(imagePack);
+            LOG_INFO("Image pack mapped: %d images, %u bytes", imagePack.count, (unsigned) imagePack.size);
+        }
+    #endif
+
     //Apply initial effect (from config if possible)
     if (_config.effectDefault != "")
         ActivateEffect(_config.effectDefault);
@@ -211,17 +272,28 @@ void setup() {
 
 void loop() {
     //Handle any web requests
-    _server.HandleClientRequests();
+    LoopPhaseBegin(LOOP_PHASE_CLIENT);
+    bool requestHandled = _server.HandleClientRequests();
+    if (LoopPhaseEnd(LOOP_PHASE_CLIENT) && requestHandled)
+        SetLoopOffenderRoute(_server.GetRequestPath());   //route served during the phase, not an older one
 
     //Handle showcase
+    LoopPhaseBegin(LOOP_PHASE_SHOWCASE);
     HandleShowcaseMode();
+    UpdateStatusOverlay();
+    HandleClock();
+    LoopPhaseEnd(LOOP_PHASE_SHOWCASE);
 
     //Handle LED display
+    LoopPhaseBegin(LOOP_PHASE_DRAW);
     DrawLEDFrame();
+    LoopPhaseEnd(LOOP_PHASE_DRAW);
 }
 
 void HandleGetEffect()
 {
+    TRACE_SCOPE("HandleGetEffect");
+
     //indicate data received
     BlinkBoardData();
 
@@ -234,6 +306,8 @@ void HandleGetEffect()
 
 void HandleSetEffect()
 {
+    TRACE_SCOPE("HandleSetEffect");
+
     //indicate data received
     BlinkBoardData();
 
@@ -246,6 +320,13 @@ void HandleSetEffect()
     p_brightness.toUpperCase();
     String p_imgname = _server.GetQueryStringParameter("imgname");
     String p_setdefault = _server.GetQueryStringParameter("setdefault");
+    String p_scroll = _server.GetQueryStringParameter("scroll");
+    String p_imgmode = _server.GetQueryStringParameter("imgmode");
+    String p_text = _server.GetQueryStringParameter("text");
+    String p_speed = _server.GetQueryStringParameter("speed");
+    String p_loop = _server.GetQueryStringParameter("loop");
+    String p_pingpong = _server.GetQueryStringParameter("pingpong");
+    String p_fps = _server.GetQueryStringParameter("fps");
 
     PrintSerial("Query String: ");
     PrintlnSerial(_server.GetRequestPath());
@@ -256,10 +337,44 @@ void HandleSetEffect()
         PrintlnSerial("brightness:" +p_brightness);
         PrintlnSerial("imgname:" + p_imgname);
         PrintlnSerial("setdefault:" + p_setdefault);
+        PrintlnSerial("scroll:" + p_scroll);
+        PrintlnSerial("imgmode:" + p_imgmode);
+        PrintlnSerial("text:" + p_text);
+        PrintlnSerial("speed:" + p_speed);
+        PrintlnSerial("loop:" + p_loop);
+        PrintlnSerial("pingpong:" + p_pingpong);
+        PrintlnSerial("fps:" + p_fps);
     #endif
 
+    //pattern scrolling applies to the built-in patterns as well
+    if (p_scroll != "")
+        SetLEDPatternScroll(p_scroll == "1");
+
+    //image fitting applies to the showcase as well
+    if (p_imgmode != "")
+        SetLEDImageMode(ParseLEDImageMode(p_imgmode));
+
+    //animation playback, also applies to the showcase
+    if (p_loop != "")
+        SetLEDAnimationLoop(p_loop == "1");
+    if (p_pingpong != "")
+        SetLEDAnimationPingPong(p_pingpong == "1");
+    if (p_fps != "")
+        SetLEDAnimationFps(p_fps.toInt());
+
+    //a custom pattern needs its definition (in color), the last one compiled is not shown again
+    if (p_effect == "pattern" && p_color == "")
+    {
+        _server.SendResponse("Missing pattern definition.", 400, "text/plain");
+        return;
+    }
+
     //Activate the effect
-    ActivateEffect(p_effect, p_color, p_brightness, p_imgname);
+    ActivateEffect(p_effect, p_color, p_brightness, p_imgname, p_text);
+
+    //travel speed in m/s (text scrolls LED_PX_PER_METER columns per m)
+    if (p_speed != "" && p_speed.toFloat() > 0)
+        SetLEDTravelSpeed(p_speed.toFloat());
 
     //Respond to client request
     String responseMesage = "Effect set to: " + p_effect;
@@ -285,9 +400,20 @@ void HandleSetEffect()
     }
 }
 
-void ActivateEffect(String effect, String color, String brightness, String imgname)
+void ActivateEffect(String effect, String color, String brightness, String imgname, String text)
 {
-    if (effect == "default")
+    TRACE_SCOPE("ActivateEffect");
+
+    //built-in presets (northpole, quebec, festive...)
+    const LedPreset *preset = FindLEDPreset(effect.c_str());
+
+    if (preset != NULL)
+    {
+        _showcaseMode=false;
+        _currentEffect = preset->name;
+        ApplyPreset(preset);
+    }
+    else if (effect == "default")
     {
         _currentEffect = "default";
         SetLEDCurrentEffect("Default");   
@@ -316,37 +442,50 @@ void ActivateEffect(String effect, String color, String brightness, String imgna
         _currentEffect = "rainbow";
         SetLEDCurrentEffect("Rainbow");
     }
-    else if (effect == "northpole")
+    else if (effect == "pattern")
     {
+        //custom pattern
         _showcaseMode=false;
-        _currentEffect = "northpole";
-        SetLEDCurrentEffect("Pattern", "FF0000000000000000FFFFFF000000000000");
+        _currentEffect = "pattern";
+        SetLEDCurrentEffect("Pattern", color);
     }
-    else if (effect == "quebec")
+    else if (effect == "image")
     {
         _showcaseMode=false;
-        _currentEffect = "quebec";
-        SetLEDCurrentEffect("Pattern", "0000FF000000000000FFFFFF000000000000");
-    }    
-    else if (effect == "festive")
+        _currentEffect = "image";
+
+        //pack images are drawn from flash, animations are streamed from the file, stills are read at once
+        String imagePath = IMAGE_DIR + imgname + IMAGE_EXT;
+        if (FindImagePackEntry(GetLEDImagePack(), imgname.c_str()) >= 0 && !FSFileExists(imagePath))
+            SetLEDCurrentEffect("Pack", imgname);
+        else if (IsLEDAnimationFile(imagePath))
+            SetLEDCurrentEffect("Animation", imagePath);
+        else
+            SetLEDCurrentEffect("Image", FSReadFile(imagePath));
+    }
+    else if (effect == "text")
     {
-        //bleu orange vert roughe jaune
         _showcaseMode=false;
-        _currentEffect = "fastive";
-        SetLEDCurrentEffect("Pattern", "0000FF00000000000000FF000000000000000000FF000000000000F3E220000000000000FF0000000000000000");
+        _currentEffect = "text";
+        if (color != "")
+            SetLEDTextColor(CRGB(HexStrToInt(color)));
+        SetLEDTravelSpeed(LED_DEFAULT_TEXT_SPEED);
+        SetLEDCurrentEffect("Text", text != "" ? text : _config.wifiHostname);
     }
-    else if (effect == "pattern")
+    else if (effect == "life")
     {
-        //custom pattern
         _showcaseMode=false;
-        _currentEffect = "pattern";
-        SetLEDCurrentEffect("Pattern", color);
+        _currentEffect = "life";
+        SetLEDTravelSpeed(LED_DEFAULT_LIFE_SPEED);
+        SetLEDCurrentEffect("Life");
     }
-    else if (effect == "image")
+    else if (effect == "fire" || effect == "noise" || effect == "cycle" || effect == "pulse")
     {
+        //computed every frame, 16ms (60 FPS) at the default speed
         _showcaseMode=false;
-        _currentEffect = "image";
-        SetLEDCurrentEffect("Image", FSReadFile(IMAGE_DIR + imgname + IMAGE_EXT));
+        _currentEffect = effect;
+        SetLEDTravelSpeed(LED_DEFAULT_FX_SPEED);
+        SetLEDCurrentEffect(effect, color);
     }
     else if (effect == "showcase")
     {
@@ -359,9 +498,40 @@ void ActivateEffect(String effect, String color, String brightness, String imgna
     }
 }
 
+//Activates a built-in preset, applying its default speed and brightness
+void ApplyPreset(const LedPreset *preset)
+{
+    char color[7];
+    snprintf(color, sizeof(color), "%06X", (unsigned int) preset->pattern.palette[0]);
+
+    switch (preset->type)
+    {
+        case LED_PRESET_PATTERN:
+            SetLEDPatternEffect(&preset->pattern);
+            break;
+        case LED_PRESET_SOLID:
+            SetLEDCurrentEffect("Solid", color);
+            break;
+        case LED_PRESET_BEAT:
+            SetLEDCurrentEffect("Beat", color);
+            break;
+        case LED_PRESET_RAINBOW:
+            SetLEDCurrentEffect("Rainbow");
+            break;
+    }
+
+    if (preset->speed > 0)
+        SetLEDTravelSpeed(preset->speed);
+
+    if (preset->brightness >= 0)
+        SetLEDBrightness(preset->brightness);
+}
+
 //Serve Main Page
 void HandleGetMainPage()
 {
+    TRACE_SCOPE("HandleGetMainPage");
+
     //indicate data received
     BlinkBoardData();
     
@@ -372,6 +542,8 @@ void HandleGetMainPage()
 //Redirect to main page
 void RedirectMainPage()
 {
+    TRACE_SCOPE("RedirectMainPage");
+
     //indicate data received
     BlinkBoardData();
 
@@ -382,6 +554,8 @@ void RedirectMainPage()
 //Serve Not Found
 void HandleNotFound()
 {
+    TRACE_SCOPE("HandleNotFound");
+
     //indicate data received
     BlinkBoardData();
     
@@ -413,7 +587,7 @@ void UpdateDeviceInfo()
 String SerializeDeviceInfo()
 {
     String info = "";
-    StaticJsonDocument<512> doc;
+    StaticJsonDocument<1024> doc;
 
     //create JSON document form global variable
     doc["device"]["hostname"] = _deviceInfo.deviceHostname;
@@ -422,6 +596,18 @@ String SerializeDeviceInfo()
     doc["device"]["mac"] = _deviceInfo.deviceMAC;
     doc["device"]["signal"] = _deviceInfo.deviceSignal;
     doc["device"]["firmware"] = _deviceInfo.firmwareVersion;
+    doc["power"]["estimate_ma"] = GetLEDPowerEstimate();
+    doc["power"]["limit_ma"] = GetLEDPowerLimit();
+    doc["power"]["brightness"] = GetLEDOutputLimitedBrightness();
+    doc["output"]["shown"] = GetLEDOutputShowCount();
+    doc["output"]["skipped"] = GetLEDOutputSkipCount();
+    doc["output"]["show_us"] = GetLEDPipelineDriverTime();
+    doc["output"]["wait_us"] = GetLEDPipelineWaitTime();
+    doc["frame"]["effect"] = GetLEDCurrentEffect();
+    doc["frame"]["target_fps"] = 1000.0f / max(1L, GetLEDFramerate());
+    doc["frame"]["fps"] = 1000.0f / max(1L, max(GetLEDFramerate(), GetLEDGovernorPeriod()));
+    doc["frame"]["frame_us"] = GetLEDGovernorFrameTime();
+    doc["frame"]["overruns"] = GetLEDGovernorOverruns();
 
     //serialize data
     serializeJson(doc, info);
@@ -433,6 +619,8 @@ String SerializeDeviceInfo()
 //Serve Raw Info
 void HandleGetInfo()
 {
+    TRACE_SCOPE("HandleGetInfo");
+
     UpdateDeviceInfo();
     _server.SendResponse(SerializeDeviceInfo(), 200, "application/json");
 }
@@ -440,6 +628,8 @@ void HandleGetInfo()
 //Serve Info Page
 void HandleGetInfoPage()
 {
+    TRACE_SCOPE("HandleGetInfoPage");
+
     UpdateDeviceInfo();
 
     //get headers and convert them to html readable format
@@ -477,19 +667,22 @@ void HandleGetInfoPage()
 //Favorite icon
 void HandleGetFavIcon()
 {
+    TRACE_SCOPE("HandleGetFavIcon");
+
     _server.SendBinaryFileResponse("/www/favicon.ico");
 }
 
 void HandleListImages()
 {
+    TRACE_SCOPE("HandleListImages");
+
     String imgListJson = "{\"FilesList\":[";
     bool firstFile = true;
 
     if(!SPIFFS.begin(true))
     {
         #ifdef DEBUGMODE
-            if (Serial)
-                Serial.println("An Error has occurred while mounting SPIFFS");
+            PrintlnSerial("An Error has occurred while mounting SPIFFS");
         #endif
 
         _server.SendResponse("Error listing files.", 500, "text/plain"); 
@@ -502,11 +695,7 @@ void HandleListImages()
       
         while(fileName != ""){
             #ifdef DEBUGMODE
-                if (Serial)
-                {
-                  Serial.print("ENUM FILE: ");
-                  Serial.println(fileName);
-                }
+                PrintlnSerial("ENUM FILE: " + fileName);
             #endif
 
             //add to array if proper extension
@@ -529,6 +718,19 @@ void HandleListImages()
         }
     }  
 
+    //images of the pack, unless a file overrides them
+    const ImagePack &pack = GetLEDImagePack();
+    ImagePackEntry entry;
+
+    for (int i = 0; i < pack.count; i++)
+    {
+        if (GetImagePackEntry(pack, i, entry) && !FSFileExists(IMAGE_DIR + String(entry.name) + IMAGE_EXT))
+        {
+            imgListJson += String(firstFile ? "\"" : ", \"") + entry.name + "\"";
+            firstFile = false;
+        }
+    }
+
     imgListJson += "]}";
 
     //return JSON list
@@ -537,12 +739,34 @@ void HandleListImages()
 
 void HandleSetImage()
 {
+    TRACE_SCOPE("HandleSetImage");
+
     String fileName = _server.GetQueryStringParameter("imgname");
     String fileData = _server.GetQueryStringParameter("imgdata");
     fileData.toUpperCase();
 
-    int fileSize = FSWriteFile(IMAGE_DIR + fileName + IMAGE_EXT, fileData);
+    //stills are stored in their smallest representation, animations as they are
+    if (!fileData.startsWith("@A") && !fileData.startsWith("@D"))
+    {
+        CRGB *pixels = (CRGB *) malloc(LED_IMAGE_MAX_PIXELS * sizeof(CRGB));
+        LedImage image = { 0, 0, pixels };
+        int errorPos = 0;
+
+        if (pixels == NULL || !DecodeLEDImage(fileData.c_str(), fileData.length(), image, LED_IMAGE_MAX_PIXELS, &errorPos))
+        {
+            free(pixels);
+            _server.SendResponse("Invalid image data at position " + String(errorPos) + ".", 400, "text/plain");
+            return;
+        }
+
+        String encoded = EncodeLEDImage(image);
+        free(pixels);
 
+        if (encoded != "")
+            fileData = encoded;
+    }
+
+    int fileSize = FSWriteFile(IMAGE_DIR + fileName + IMAGE_EXT, fileData);
     if (fileSize == -1)
     {
         #ifdef DEBUGMODE
@@ -565,7 +789,9 @@ void HandleSetImage()
 }
 
 void HandleGetImage()
-{  
+{
+    TRACE_SCOPE("HandleGetImage");
+
     String fileName = IMAGE_DIR +  _server.GetQueryStringParameter("imgname") + IMAGE_EXT;
     
     if (FSFileExists(fileName))
@@ -586,6 +812,8 @@ void HandleGetImage()
 
 void HandleDeleteImage()
 {
+    TRACE_SCOPE("HandleDeleteImage");
+
     String fileName = _server.GetQueryStringParameter("imgname");
 
     if (FSDeleteFile(IMAGE_DIR + fileName + IMAGE_EXT))
@@ -609,6 +837,8 @@ void HandleDeleteImage()
 
 void HandleGetStorageInfo()
 {
+    TRACE_SCOPE("HandleGetStorageInfo");
+
     if (!SPIFFS.begin(true))
     {
         #ifdef DEBUGMODE
@@ -629,13 +859,37 @@ void HandleGetStorageInfo()
             PrintlnSerial(String(used));
         #endif
 
-        String info = "{\"TotalBytes\":" + String(total) + ", \"UsedBytes\":" + String(used) + "}" ;
+        //compression of the image store: stored size against plain RRGGBB
+        size_t imageBytes = 0;
+        size_t rawBytes = 0;
+        File root = SPIFFS.open("/images"); //IT DOES NOT LIKE THE TRAILING "/"
+        File file = root.openNextFile();
+
+        while (file)
+        {
+            char header[32];
+            size_t length = file.read((uint8_t *) header, sizeof(header));
+
+            imageBytes += file.size();
+            rawBytes += GetLEDImageRawLength(header, length, file.size());
+
+            file.close();
+            file = root.openNextFile();
+        }
+
+        float ratio = (imageBytes > 0) ? (float) rawBytes / imageBytes : 1.0f;
+
+        String info = "{\"TotalBytes\":" + String(total) + ", \"UsedBytes\":" + String(used)
+            + ", \"ImageBytes\":" + String(imageBytes) + ", \"ImageRawBytes\":" + String(rawBytes)
+            + ", \"CompressionRatio\":" + String(ratio, 2) + "}" ;
         _server.SendResponse(info, 200, "application/json");
     }   
 }
 
 String GetImageById(int imgID)
 {
+    TRACE_SCOPE("GetImageById");
+
     int currentId = 0;
 
     //iterate through files
@@ -701,7 +955,10 @@ void HandleShowcaseMode()
             _showcaseImageIndex++;
 
             //display image
-            SetLEDCurrentEffect("Image", FSReadFile(imgName));
+            if (IsLEDAnimationFile(imgName))
+                SetLEDCurrentEffect("Animation", imgName);
+            else
+                SetLEDCurrentEffect("Image", FSReadFile(imgName));
         }
     }
 }
@@ -709,12 +966,14 @@ void HandleShowcaseMode()
 
 bool DeserializeConfig(String conf)
 {
-    StaticJsonDocument<512> doc;
+    StaticJsonDocument<1024> doc;
     deserializeJson(doc, conf);
 
     #ifdef DEBUGMODE
+        String prettyConf = "";
+        serializeJsonPretty(doc, prettyConf);
         PrintlnSerial("Deserialized config:");
-        serializeJsonPretty(doc, Serial);
+        PrintlnSerial(prettyConf);
     #endif
 
     //load config data into global variable
@@ -723,6 +982,26 @@ bool DeserializeConfig(String conf)
     _config.wifiSSID = doc["wifi"]["ssid"].as<String>();
     _config.wifiTimeout = doc["wifi"]["timeout"];
     _config.effectDefault = doc["effect"]["default"].as<String>();
+    _config.monitorBudget = doc["monitor"]["budget"] | _config.monitorBudget;
+    _config.outputGamma = doc["output"]["gamma"] | _config.outputGamma;
+    _config.outputCorrection = doc["output"]["correction"] | _config.outputCorrection;
+    _config.powerLimit = doc["power"]["limit_ma"] | _config.powerLimit;
+    _config.imageMode = doc["image"]["mode"] | _config.imageMode;
+    _config.timeServer = doc["time"]["server"] | _config.timeServer;
+    _config.timeZone = doc["time"]["timezone"] | _config.timeZone;
+    _config.clockEnabled = doc["clock"]["enabled"] | _config.clockEnabled;
+    _config.clockSeconds = doc["clock"]["seconds"] | _config.clockSeconds;
+    _config.clockColor = doc["clock"]["color"] | _config.clockColor;
+
+    //apply settings that do not require a reboot
+    SetLoopMonitorBudget(_config.monitorBudget);
+    SetLEDOutputGamma(_config.outputGamma);
+    SetLEDOutputCorrection(HexStrToInt(_config.outputCorrection));
+    SetLEDPowerLimit(_config.powerLimit);
+    SetLEDImageMode(ParseLEDImageMode(_config.imageMode));
+    SetLEDClockEnabled(_config.clockEnabled);
+    SetLEDClockSeconds(_config.clockSeconds);
+    SetLEDClockColor(CRGB(HexStrToInt(_config.clockColor)));
 
     return true; //success
 }
@@ -730,7 +1009,7 @@ bool DeserializeConfig(String conf)
 String SerializeConfig(bool maskPassword=false)
 {
     String conf = "";
-    StaticJsonDocument<512> doc;
+    StaticJsonDocument<1024> doc;
 
     //create JSON document form global variable
     doc["wifi"]["hostname"] = _config.wifiHostname;
@@ -738,6 +1017,16 @@ String SerializeConfig(bool maskPassword=false)
     doc["wifi"]["ssid"] = _config.wifiSSID;
     doc["wifi"]["timeout"] = _config.wifiTimeout;
     doc["effect"]["default"] = _config.effectDefault;
+    doc["monitor"]["budget"] = _config.monitorBudget;
+    doc["output"]["gamma"] = _config.outputGamma;
+    doc["output"]["correction"] = _config.outputCorrection;
+    doc["power"]["limit_ma"] = _config.powerLimit;
+    doc["image"]["mode"] = _config.imageMode;
+    doc["time"]["server"] = _config.timeServer;
+    doc["time"]["timezone"] = _config.timeZone;
+    doc["clock"]["enabled"] = _config.clockEnabled;
+    doc["clock"]["seconds"] = _config.clockSeconds;
+    doc["clock"]["color"] = _config.clockColor;
 
     if (maskPassword)
         doc["wifi"]["pwd"]="";
@@ -785,6 +1074,8 @@ bool SaveConfig()
 //Configuration Webpage
 void HandleConfigPage()
 {
+    TRACE_SCOPE("HandleConfigPage");
+
     //indicate data received
     BlinkBoardData();
     
@@ -795,6 +1086,8 @@ void HandleConfigPage()
 //Handle config API PUT
 void HandleSetConfig()
 {
+    TRACE_SCOPE("HandleSetConfig");
+
     String configData = _server.GetQueryStringParameter("configdata");
 
     #ifdef DEBUGMODE
@@ -818,6 +1111,8 @@ void HandleSetConfig()
 //Handle config API GET
 void HandleGetConfig()
 {
+    TRACE_SCOPE("HandleGetConfig");
+
     String configData = SerializeConfig(true);
 
     _server.SendResponse(configData, 200, "application/json");
@@ -826,4 +1121,309 @@ void HandleGetConfig()
 void HandleReboot()
 {
     ESP.restart();
-}
\ No newline at end of file
+}
+
+//Handle trace API GET - download the trace buffer as Chrome trace-event JSON
+void HandleGetTrace()
+{
+    //pause recording so the buffer does not move while exporting
+    bool wasEnabled = GetTraceEnabled();
+    SetTraceEnabled(false);
+
+    _server.BeginChunkedResponse(200, "application/json");
+
+    int cursor = 0;
+    String chunk = "";
+    while (GetTraceJsonChunk(cursor, chunk))
+        _server.SendResponseChunk(chunk);
+
+    _server.EndChunkedResponse();
+
+    SetTraceEnabled(wasEnabled);
+}
+
+//Handle trace API PUT - start/stop recording, optionally clearing the buffer
+void HandleSetTrace()
+{
+    String p_enabled = _server.GetQueryStringParameter("enabled");
+    String p_clear = _server.GetQueryStringParameter("clear");
+
+    if (p_clear == "1")
+        ClearTrace();
+
+    if (p_enabled != "")
+        SetTraceEnabled(p_enabled == "1");
+
+    String info = "{\"enabled\": " + String(GetTraceEnabled() ? "true" : "false") + ", \"events\": " + String(GetTraceEventCount()) + "}";
+    _server.SendResponse(info, 200, "application/json");
+}
+
+//Handle loop monitor API GET
+void HandleGetMonitor()
+{
+    _server.SendResponse(SerializeLoopMonitor(), 200, "application/json");
+}
+
+//Handle loop monitor API PUT - change the phase budget and/or reset statistics
+void HandleSetMonitor()
+{
+    String p_budget = _server.GetQueryStringParameter("budget");
+    String p_reset = _server.GetQueryStringParameter("reset");
+
+    if (p_reset == "1")
+        ResetLoopMonitor();
+
+    if (p_budget != "")
+    {
+        SetLoopMonitorBudget(p_budget.toInt());
+        _config.monitorBudget = GetLoopMonitorBudget();
+        SaveConfig();
+    }
+
+    _server.SendResponse(SerializeLoopMonitor(), 200, "application/json");
+}
+
+//Handle log API GET - last lines written to the serial log
+void HandleGetLog()
+{
+    String p_lines = _server.GetQueryStringParameter("lines");
+
+    int lines = LOG_TAIL_LINES;
+    if (p_lines != "")
+        lines = p_lines.toInt();
+
+    String tail = GetLogTail(lines);
+    if (GetLogDroppedCount() > 0)
+        tail += "(" + String(GetLogDroppedCount()) + " messages dropped)\n";
+    if (GetLogThrottledCount() > 0)
+        tail += "(" + String(GetLogThrottledCount()) + " messages over the rate limit)\n";
+
+    _server.SendResponse(tail, 200, "text/plain");
+}
+
+String SerializePresets()
+{
+    String info = "";
+    DynamicJsonDocument doc(4096);
+
+    //create JSON document from the preset table
+    JsonArray presets = doc.createNestedArray("presets");
+    for (int i = 0; i < GetLEDPresetCount(); i++)
+    {
+        const LedPreset *preset = GetLEDPreset(i);
+        JsonObject p = presets.createNestedObject();
+        p["name"] = preset->name;
+        p["effect"] = GetLEDPresetTypeName(preset->type);
+        p["speed"] = preset->speed;
+        p["brightness"] = preset->brightness;
+
+        //colours of the pattern, in order
+        JsonArray colors = p.createNestedArray("colors");
+        for (int j = 0; j < preset->pattern.length; j++)
+        {
+            char color[7];
+            snprintf(color, sizeof(color), "%06X", (unsigned int) preset->pattern.palette[preset->pattern.indexes[j]]);
+            colors.add(color);
+        }
+    }
+
+    //serialize data
+    serializeJson(doc, info);
+
+    return info;
+}
+
+//Handle presets API GET - list of built-in presets
+void HandleGetPresets()
+{
+    _server.SendResponse(SerializePresets(), 200, "application/json");
+}
+
+//Handle overlay API GET - state of the overlay layers
+void HandleGetOverlay()
+{
+    _server.SendResponse(SerializeLEDLayers(), 200, "application/json");
+}
+
+//Handle overlay API PUT - draw on the general purpose overlay layer
+void HandleSetOverlay()
+{
+    TRACE_SCOPE("HandleSetOverlay");
+
+    String p_clear = _server.GetQueryStringParameter("clear");
+    String p_visible = _server.GetQueryStringParameter("visible");
+    String p_blend = _server.GetQueryStringParameter("blend");
+    String p_opacity = _server.GetQueryStringParameter("opacity");
+    String p_rect = _server.GetQueryStringParameter("rect");
+    String p_color = _server.GetQueryStringParameter("color");
+    String p_alpha = _server.GetQueryStringParameter("alpha");
+
+    if (p_clear == "1")
+        ClearLEDLayer(LED_LAYER_OVERLAY);
+
+    if (p_visible != "")
+        SetLEDLayerVisible(LED_LAYER_OVERLAY, p_visible == "1");
+
+    if (p_blend != "" || p_opacity != "")
+    {
+        int opacity = (p_opacity != "") ? p_opacity.toInt() : 255;
+        opacity = (opacity < 0) ? 0 : (opacity > 255) ? 255 : opacity;
+        SetLEDLayerBlend(LED_LAYER_OVERLAY, ParseLEDBlendMode(p_blend), opacity);
+    }
+
+    //rect=x,y,width,height filled with color (RRGGBB)
+    if (p_rect != "")
+    {
+        int r[4] = { 0, 0, 0, 0 };
+        int start = 0;
+
+        for (int i = 0; i < 4; i++)
+        {
+            int comma = p_rect.indexOf(',', start);
+            r[i] = p_rect.substring(start, comma < 0 ? p_rect.length() : comma).toInt();
+            if (comma < 0)
+                break;
+            start = comma + 1;
+        }
+
+        int alpha = (p_alpha != "") ? p_alpha.toInt() : 255;
+        alpha = (alpha < 0) ? 0 : (alpha > 255) ? 255 : alpha;
+        FillLEDLayerRect(LED_LAYER_OVERLAY, r[0], r[1], r[2], r[3], CRGB(HexStrToInt(p_color)), alpha);
+    }
+
+    _server.SendResponse(SerializeLEDLayers(), 200, "application/json");
+}
+
+//Shows the connection state in the top right corner: blue in configuration (AP) mode, red when WiFi is lost
+void UpdateStatusOverlay()
+{
+    static unsigned long previousCheck = 0;
+
+    //no need to check every loop
+    if (millis() - previousCheck < 1000)
+        return;
+    previousCheck = millis();
+
+    CRGB status = CRGB::Black;
+    uint8_t alpha = 255;
+    if (_server.IsAPConnected())
+        status = CRGB(0, 0, 48);
+    else if (!_server.IsWiFiConnected())
+        status = CRGB(48, 0, 0);
+    else
+        alpha = 0;
+
+    //only changes are pushed to the strip
+    SetLEDLayerPixel(LED_LAYER_STATUS, LED_MATRIX_WIDTH - 1, 0, status, alpha);
+}
+
+//Handle clock API PUT - show, hide or restyle the clock overlay (saved as the default)
+void HandleSetClock()
+{
+    TRACE_SCOPE("HandleSetClock");
+
+    String p_enabled = _server.GetQueryStringParameter("enabled");
+    String p_seconds = _server.GetQueryStringParameter("seconds");
+    String p_color = _server.GetQueryStringParameter("color");
+    p_color.toUpperCase();
+
+    if (p_enabled != "")
+        _config.clockEnabled = (p_enabled == "1");
+    if (p_seconds != "")
+        _config.clockSeconds = (p_seconds == "1");
+    if (p_color != "")
+        _config.clockColor = p_color;
+
+    SetLEDClockEnabled(_config.clockEnabled);
+    SetLEDClockSeconds(_config.clockSeconds);
+    SetLEDClockColor(CRGB(HexStrToInt(_config.clockColor)));
+    SaveConfig();
+
+    _server.SendResponse("Clock " + String(_config.clockEnabled ? "enabled" : "disabled"));
+}
+
+//Keeps the clock overlay up to date, from the cached time base (no allocation)
+void HandleClock()
+{
+    if (!GetLEDClockEnabled())
+        return;
+
+    int hours, minutes, seconds;
+    if (_timeLord.GetLocalClock(hours, minutes, seconds))
+        UpdateLEDClock(hours, minutes, seconds);
+}
+
+//Handle sprite API GET - sprites on screen and images loaded
+void HandleGetSprites()
+{
+    _server.SendResponse(SerializeLEDSprites(), 200, "application/json");
+}
+
+//Handle sprite API PUT - add (imgname, no id), change (id) or remove (id, remove=1) a sprite
+void HandleSetSprite()
+{
+    TRACE_SCOPE("HandleSetSprite");
+
+    String p_id = _server.GetQueryStringParameter("id");
+    String p_imgname = _server.GetQueryStringParameter("imgname");
+    String p_key = _server.GetQueryStringParameter("key");
+    String p_x = _server.GetQueryStringParameter("x");
+    String p_y = _server.GetQueryStringParameter("y");
+    String p_z = _server.GetQueryStringParameter("z");
+    String p_vx = _server.GetQueryStringParameter("vx");
+    String p_vy = _server.GetQueryStringParameter("vy");
+    String p_edge = _server.GetQueryStringParameter("edge");
+    String p_visible = _server.GetQueryStringParameter("visible");
+    String p_remove = _server.GetQueryStringParameter("remove");
+    String p_clear = _server.GetQueryStringParameter("clear");
+
+    if (p_clear == "1")
+    {
+        ClearLEDSprites();
+        _server.SendResponse(SerializeLEDSprites(), 200, "application/json");
+        return;
+    }
+
+    int sprite = -1;
+
+    if (p_id == "")
+    {
+        //new sprite, its image comes from the image store (loaded once per name)
+        int image = FindLEDSpriteImage(p_imgname.c_str());
+        if (image < 0 && FSFileExists(IMAGE_DIR + p_imgname + IMAGE_EXT))
+        {
+            CRGB key = (p_key != "") ? CRGB(HexStrToInt(p_key)) : CRGB(CRGB::Black);
+            image = LoadLEDSpriteImage(p_imgname.c_str(), FSReadFile(IMAGE_DIR + p_imgname + IMAGE_EXT), key);
+        }
+
+        sprite = AddLEDSprite(image, p_x.toInt(), p_y.toInt(), p_z.toInt());
+        if (sprite < 0)
+        {
+            _server.SendResponse("Unable to add sprite " + p_imgname, 400, "text/plain");
+            return;
+        }
+    }
+    else
+    {
+        sprite = p_id.toInt();
+
+        if (p_remove == "1")
+            RemoveLEDSprite(sprite);
+        else
+        {
+            if (p_x != "" && p_y != "")
+                MoveLEDSprite(sprite, p_x.toInt(), p_y.toInt());
+            if (p_z != "")
+                SetLEDSpriteZ(sprite, p_z.toInt());
+        }
+    }
+
+    if (p_vx != "" || p_vy != "")
+        SetLEDSpriteVelocity(sprite, p_vx.toFloat(), p_vy.toFloat());
+    if (p_edge != "")
+        SetLEDSpriteEdge(sprite, ParseLEDSpriteEdge(p_edge));
+    if (p_visible != "")
+        SetLEDSpriteVisible(sprite, p_visible == "1");
+
+    _server.SendResponse(SerializeLEDSprites(), 200, "application/json");
+}
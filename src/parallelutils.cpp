@@ -0,0 +1,129 @@
+//+--------------------------------------------------------------------------
+//
+// File:        parallelutils.cpp
+//
+// Description: The purpose of this file is to provide a minimal parallel
+//              for over frame rows: the rows of a job declared row
+//              independent are split between the loop task and a helper
+//              task on the other core, then joined before the frame is
+//              shown. On the host the helper is a std::thread, so jobs can
+//              be checked and benchmarked there.
+//
+// History:     2026-10-18    PP Laplante   Created
+//
+//
+//---------------------------------------------------------------------------
+#include <Arduino.h>
+#include <parallelutils.h>
+
+#if PARALLEL_ENABLED && !defined(ESP32)
+#include <condition_variable>
+#include <mutex>
+#include <thread>
+#endif
+
+//Global variables
+bool parallelStarted = false;                       //helper running
+ParallelRowsJob parallelJob = NULL;                 //job handed to the helper
+void *parallelContext = NULL;                       //its context
+int parallelLast = 0;                               //rows [0, parallelLast) go to the helper
+
+#if PARALLEL_ENABLED
+#ifdef ESP32
+TaskHandle_t parallelTask = NULL;                   //helper task
+SemaphoreHandle_t parallelDone = NULL;              //given by the helper after its rows
+#else
+std::mutex *parallelMutex = NULL;                   //guards the flags below (never freed: the thread outlives main)
+std::condition_variable *parallelSignal = NULL;     //flags changed
+bool parallelSubmitted = false;                     //rows wait for the helper
+bool parallelHelperDone = false;                    //the helper finished its rows
+#endif
+#endif
+
+#if PARALLEL_ENABLED
+#ifdef ESP32
+//Helper task: one half job per notification
+void ParallelTask(void *parameters)
+{
+    for (;;)
+    {
+        ulTaskNotifyTake(pdTRUE, portMAX_DELAY);
+        parallelJob(0, parallelLast, parallelContext);
+        xSemaphoreGive(parallelDone);
+    }
+}
+#else
+//Helper thread (host): one half job per submission
+void ParallelThread()
+{
+    std::unique_lock<std::mutex> lock(*parallelMutex);
+
+    for (;;)
+    {
+        parallelSignal->wait(lock, [] { return parallelSubmitted; });
+        parallelSubmitted = false;
+
+        lock.unlock();
+        parallelJob(0, parallelLast, parallelContext);
+        lock.lock();
+
+        parallelHelperDone = true;
+        parallelSignal->notify_all();
+    }
+}
+#endif
+#endif
+
+//Starts the helper task
+void InitParallel()
+{
+    #if PARALLEL_ENABLED
+        if (parallelStarted)
+            return;
+
+        #ifdef ESP32
+            parallelDone = xSemaphoreCreateBinary();
+            xTaskCreatePinnedToCore(ParallelTask, "Parallel", 4096, NULL, PARALLEL_PRIORITY, &parallelTask, PARALLEL_CORE);
+        #else
+            parallelMutex = new std::mutex();
+            parallelSignal = new std::condition_variable();
+            std::thread(ParallelThread).detach();
+        #endif
+
+        parallelStarted = true;
+    #endif
+}
+
+//Runs a job over rows [0, rows): the helper task takes the first half, the caller the second
+void ParallelForRows(int rows, ParallelRowsJob job, void *context)
+{
+    if (!parallelStarted || rows < PARALLEL_MIN_ROWS)
+    {
+        job(0, rows, context);
+        return;
+    }
+
+    parallelJob = job;
+    parallelContext = context;
+    parallelLast = rows / 2;
+
+    #if PARALLEL_ENABLED
+        #ifdef ESP32
+            xTaskNotifyGive(parallelTask);
+            job(parallelLast, rows, context);
+            xSemaphoreTake(parallelDone, portMAX_DELAY);
+        #else
+            {
+                std::lock_guard<std::mutex> lock(*parallelMutex);
+                parallelSubmitted = true;
+                parallelSignal->notify_all();
+            }
+
+            job(parallelLast, rows, context);
+
+            std::unique_lock<std::mutex> lock(*parallelMutex);
+            parallelSignal->wait(lock, [] { return parallelHelperDone; });
+            parallelHelperDone = false;
+        #endif
+    #endif
+}
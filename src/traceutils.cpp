@@ -0,0 +1,155 @@
+//+--------------------------------------------------------------------------
+//
+// File:        traceutils.cpp
+//
+// Description: The purpose of this file is to provide a fixed size, in RAM
+//              event trace of the hot paths, exportable as Chrome trace-event
+//              JSON (open in chrome://tracing or https://ui.perfetto.dev).
+//
+// History:     2026-10-18    PP Laplante   Created
+//
+//
+//---------------------------------------------------------------------------
+#include <Arduino.h>
+#include <esp_timer.h>
+#include <traceutils.h>
+
+struct TraceEvent
+{
+    uint64_t    cycles;         //extended cycle counter when recorded
+    const char *name;           //string literal, only the pointer is kept
+    char        phase;          //'B' begin, 'E' end
+};
+
+//Global variables
+bool traceEnabled = TRACE_DEFAULT_ENABLED;      //is recording active
+int traceEventCount = 0;                        //number of valid events
+int traceNextIndex = 0;                         //next slot to write
+
+#ifdef TRACEUTILS_ENABLED
+TraceEvent traceEvents[TRACE_BUFFER_SIZE];      //ring buffer
+bool traceCyclesSynced = false;                 //traceCycleOffset set
+uint64_t traceCycleOffset = 0;                  //extended cycle count minus the esp_timer time in cycles
+uint32_t traceCyclesPerUs = 0;                  //CPU frequency when synced
+#endif
+
+#ifdef TRACEUTILS_ENABLED
+//Gets the cycle counter extended to 64 bits: the 32-bit counter wraps every ~18s at 240MHz, the high
+//word comes from esp_timer (64-bit us) so events further apart than a wrap keep their distance
+uint64_t GetTraceCycles()
+{
+    uint32_t cycles = ESP.getCycleCount();
+    uint64_t now = (uint64_t) esp_timer_get_time();
+
+    if (!traceCyclesSynced)
+    {
+        traceCyclesPerUs = ESP.getCpuFreqMHz();
+        traceCycleOffset = cycles - now * traceCyclesPerUs;
+        traceCyclesSynced = true;
+    }
+
+    //the count ending in these 32 bits closest to the timer estimate, exact while both agree within 2^31 cycles (~9s)
+    uint64_t estimate = now * traceCyclesPerUs + traceCycleOffset;
+    return estimate + (int32_t) (cycles - (uint32_t) estimate);
+}
+#endif
+
+//Records a trace event (phase 'B' for begin, 'E' for end) - loop task only
+void TraceRecord(const char *name, char phase)
+{
+    #ifdef TRACEUTILS_ENABLED
+        if (!traceEnabled)
+            return;
+
+        //overwrite the oldest event when full
+        TraceEvent &e = traceEvents[traceNextIndex];
+        e.cycles = GetTraceCycles();
+        e.name = name;
+        e.phase = phase;
+
+        traceNextIndex = (traceNextIndex + 1) % TRACE_BUFFER_SIZE;
+        if (traceEventCount < TRACE_BUFFER_SIZE)
+            traceEventCount++;
+    #endif
+}
+
+//Enables or disables recording at runtime
+void SetTraceEnabled(bool enabled)
+{
+    #ifdef TRACEUTILS_ENABLED
+        traceEnabled = enabled;
+    #else
+        traceEnabled = false;
+    #endif
+}
+
+//Gets if recording is currently active
+bool GetTraceEnabled()
+{
+    return traceEnabled;
+}
+
+//Discards all recorded events
+void ClearTrace()
+{
+    traceEventCount = 0;
+    traceNextIndex = 0;
+}
+
+//Gets the number of events currently held in the buffer
+int GetTraceEventCount()
+{
+    return traceEventCount;
+}
+
+//Gets the next chunk of Chrome trace-event JSON, returns false when nothing is left
+bool GetTraceJsonChunk(int &cursor, String &chunk)
+{
+    //cursor goes from 0 (header), through each event, to count+1 (footer)
+    if (cursor > traceEventCount + 1)
+        return false;
+
+    chunk = "";
+
+    if (cursor == 0)
+    {
+        chunk = "{\"displayTimeUnit\":\"ms\",\"traceEvents\":[";
+        cursor++;
+    }
+
+    #ifdef TRACEUTILS_ENABLED
+        //timestamps are relative to the oldest event, in microseconds
+        int oldest = (traceNextIndex - traceEventCount + TRACE_BUFFER_SIZE) % TRACE_BUFFER_SIZE;
+        uint64_t origin = traceEvents[oldest].cycles;
+        uint32_t cyclesPerUs = ESP.getCpuFreqMHz();
+
+        //keep chunks around 1KB
+        while (cursor <= traceEventCount && chunk.length() < 1024)
+        {
+            const TraceEvent &e = traceEvents[(oldest + cursor - 1) % TRACE_BUFFER_SIZE];
+            double ts = (double) (e.cycles - origin) / cyclesPerUs;
+
+            if (cursor > 1)
+                chunk += ",";
+            chunk += "{\"name\":\"";
+            chunk += e.name;
+            chunk += "\",\"ph\":\"";
+            chunk += e.phase;
+            chunk += "\",\"ts\":";
+            chunk += String(ts, 3);
+            chunk += ",\"pid\":1,\"tid\":1}";
+
+            cursor++;
+        }
+    #else
+        cursor = traceEventCount + 1;
+    #endif
+
+    if (cursor == traceEventCount + 1)
+    {
+        chunk += "]}";
+        cursor++;
+    }
+
+    return true;
+}
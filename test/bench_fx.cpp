@@ -0,0 +1,56 @@
+//+--------------------------------------------------------------------------
+//
+// File:        bench_fx.cpp
+//
+// Description: Host benchmark of the fire and noise kernels (fxutils). The
+//              effects must reach 60 FPS on a 16x16 panel with CPU time
+//              left for the web server: a kernel is flagged when it takes
+//              more than LED_FX_BUDGET_PERCENT of a 60 FPS frame on the
+//              host. The ESP32 is roughly 20 to 50 times slower than a
+//              desktop core for this kind of code, hence the small budget.
+//
+// History:     2026-10-18    PP Laplante   Created
+//
+//
+//---------------------------------------------------------------------------
+#include <stdint.h>
+#include <testutils.h>
+#include <fxutils.h>
+
+#define LED_FX_FRAME_US         16667.0     //one frame at 60 FPS
+#define LED_FX_BUDGET_PERCENT   1.0         //of a frame on the host
+
+volatile uint32_t benchSink = 0;            //keeps the results alive
+
+//Benchmarks both kernels on a width x height grid
+void BenchmarkFx(int width, int height, int iterations)
+{
+    uint8_t values[64 * 64] = { 0 };
+    uint32_t rng = 1;
+    uint16_t t = 0;
+
+    double fire = BenchmarkMicros(iterations, [&] {
+        FireStep(values, width, height, 55, 120, rng);
+        benchSink += values[0];
+    });
+
+    double noise = BenchmarkMicros(iterations, [&] {
+        t++;
+        NoiseFill(values, width, height, t * 3, t * 2, t * 8, 40);
+        benchSink += values[0];
+    });
+
+    printf("%dx%d fire:  %8.2f us/frame (%.3f%% of 60 FPS)\n", width, height, fire, fire * 100 / LED_FX_FRAME_US);
+    printf("%dx%d noise: %8.2f us/frame (%.3f%% of 60 FPS)\n", width, height, noise, noise * 100 / LED_FX_FRAME_US);
+
+    CHECK(fire < LED_FX_FRAME_US * LED_FX_BUDGET_PERCENT / 100);
+    CHECK(noise < LED_FX_FRAME_US * LED_FX_BUDGET_PERCENT / 100);
+}
+
+int main()
+{
+    BenchmarkFx(16, 16, 20000);
+    BenchmarkFx(32, 32, 5000);
+
+    return TestResult();
+}
@@ -0,0 +1,50 @@
+#ifndef Arduino_h
+#define Arduino_h
+
+//Host stand-in for the few Arduino definitions the tested firmware modules use
+
+#include <ctype.h>
+#include <stddef.h>
+#include <stdint.h>
+#include <stdlib.h>
+#include <string.h>
+#include <string>
+
+//Arduino String, the members used by the tested modules only
+class String
+{
+public:
+    String(const char *text = "") : _text(text) {}
+
+    const char *c_str() const { return _text.c_str(); }
+    unsigned int length() const { return _text.length(); }
+
+    void trim()
+    {
+        size_t first = _text.find_first_not_of(" \t\r\n");
+        size_t last = _text.find_last_not_of(" \t\r\n");
+        _text = (first == std::string::npos) ? "" : _text.substr(first, last - first + 1);
+    }
+
+    void toLowerCase()
+    {
+        for (char &c : _text)
+            c = tolower((unsigned char) c);
+    }
+
+    bool operator==(const char *rhs) const { return _text == rhs; }
+    bool operator!=(const char *rhs) const { return _text != rhs; }
+
+private:
+    std::string _text;
+};
+
+//Time since the program started
+unsigned long micros();
+unsigned long millis();
+
+//Sleeps the calling thread
+void delay(unsigned long ms);
+void delayMicroseconds(unsigned int us);
+
+#endif
@@ -0,0 +1,25 @@
+#ifndef FastLED_h
+#define FastLED_h
+
+//Host stand-in for the FastLED pixel type, same layout as the library one
+
+#include <stdint.h>
+
+struct CRGB
+{
+    uint8_t r;
+    uint8_t g;
+    uint8_t b;
+
+    enum HTMLColorCode { Black = 0x000000, White = 0xFFFFFF };
+
+    CRGB() = default;
+    constexpr CRGB(uint8_t red, uint8_t green, uint8_t blue) : r(red), g(green), b(blue) {}
+    constexpr CRGB(uint32_t color) : r(color >> 16), g(color >> 8), b(color) {}
+    constexpr CRGB(HTMLColorCode color) : CRGB((uint32_t) color) {}
+
+    bool operator==(const CRGB &rhs) const { return r == rhs.r && g == rhs.g && b == rhs.b; }
+    bool operator!=(const CRGB &rhs) const { return !(*this == rhs); }
+};
+
+#endif
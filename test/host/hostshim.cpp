@@ -0,0 +1,43 @@
+//+--------------------------------------------------------------------------
+//
+// File:        hostshim.cpp
+//
+// Description: Host implementations of the Arduino timing functions and of
+//              the trace recorder, for the host tests of firmware modules
+//              that include Arduino.h (see test/host).
+//
+// History:     2026-10-18    PP Laplante   Created
+//
+//
+//---------------------------------------------------------------------------
+#include <chrono>
+#include <thread>
+#include <Arduino.h>
+
+//Global variables
+static const std::chrono::steady_clock::time_point hostStart = std::chrono::steady_clock::now();
+
+unsigned long micros()
+{
+    return std::chrono::duration_cast<std::chrono::microseconds>(std::chrono::steady_clock::now() - hostStart).count();
+}
+
+unsigned long millis()
+{
+    return micros() / 1000;
+}
+
+void delay(unsigned long ms)
+{
+    std::this_thread::sleep_for(std::chrono::milliseconds(ms));
+}
+
+void delayMicroseconds(unsigned int us)
+{
+    std::this_thread::sleep_for(std::chrono::microseconds(us));
+}
+
+//Tracing is not recorded on the host
+void TraceRecord(const char *name, char phase)
+{
+}
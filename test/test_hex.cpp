@@ -0,0 +1,185 @@
+//+--------------------------------------------------------------------------
+//
+// File:        test_hex.cpp
+//
+// Description: Fuzzes the bulk hexadecimal decoder (hexutils) against a
+//              strtol based reference, results and error positions, and
+//              benchmarks it against the substring + strtol per pixel path
+//              it replaced.
+//
+// History:     2026-10-18    PP Laplante   Created
+//
+//
+//---------------------------------------------------------------------------
+#include <ctype.h>
+#include <stdint.h>
+#include <stdlib.h>
+#include <string.h>
+#include <string>
+#include <testutils.h>
+#include <hexutils.h>
+
+#define HEX_FUZZ_ITERATIONS     200000
+#define HEX_FUZZ_MAX_LENGTH     80
+
+volatile uint32_t benchSink = 0;            //keeps the results alive
+
+//Reference decoder: strict validation, then strtol per byte
+int ReferenceHexDecode(const char *hex, size_t hexLength, uint8_t *out, size_t outSize, int *errorPos)
+{
+    if (hexLength / 2 > outSize)
+    {
+        *errorPos = outSize * 2;
+        return -1;
+    }
+
+    if (hexLength % 2 != 0)
+    {
+        *errorPos = hexLength - 1;
+        return -1;
+    }
+
+    //strtol alone would accept signs, spaces and 0x prefixes
+    for (size_t i = 0; i < hexLength; i++)
+    {
+        if (!isxdigit((unsigned char) hex[i]))
+        {
+            *errorPos = i;
+            return -1;
+        }
+    }
+
+    for (size_t i = 0; i < hexLength; i += 2)
+    {
+        char pair[3] = { hex[i], hex[i + 1], '\0' };
+        out[i / 2] = (uint8_t) strtol(pair, NULL, 16);
+    }
+
+    return hexLength / 2;
+}
+
+//Gets a random character, mostly hexadecimal
+char FuzzHexCharacter(uint32_t &rng)
+{
+    static const char hexDigits[] = "0123456789abcdefABCDEF";
+    static const char invalid[] = { 'g', 'G', 'x', ' ', '+', '-', '/', ':', '@', '`', '\0', (char) 0x80, (char) 0xB0, (char) 0xE6 };
+
+    rng = rng * 1103515245u + 12345u;
+    uint32_t r = rng >> 8;
+
+    if (r % 64 == 0)
+        return invalid[(r / 64) % sizeof(invalid)];
+
+    return hexDigits[(r / 64) % (sizeof(hexDigits) - 1)];
+}
+
+//Decodes random text with both decoders and compares everything
+void FuzzHexDecode()
+{
+    uint32_t rng = 1;
+    char hex[HEX_FUZZ_MAX_LENGTH];
+
+    for (int n = 0; n < HEX_FUZZ_ITERATIONS; n++)
+    {
+        rng = rng * 1103515245u + 12345u;
+        size_t length = (rng >> 8) % (HEX_FUZZ_MAX_LENGTH + 1);
+        size_t outSize = ((rng >> 20) % 8 == 0) ? (rng >> 4) % (HEX_FUZZ_MAX_LENGTH / 2) : HEX_FUZZ_MAX_LENGTH / 2;
+
+        for (size_t i = 0; i < length; i++)
+            hex[i] = FuzzHexCharacter(rng);
+
+        uint8_t out[HEX_FUZZ_MAX_LENGTH / 2], expected[HEX_FUZZ_MAX_LENGTH / 2];
+        int errorPos = -2, expectedPos = -2;
+
+        int result = HexDecode(hex, length, out, outSize, &errorPos);
+        int expectedResult = ReferenceHexDecode(hex, length, expected, outSize, &expectedPos);
+
+        if (result != expectedResult || (result < 0 && errorPos != expectedPos) || (result > 0 && memcmp(out, expected, result) != 0))
+        {
+            printf("'%.*s' (%zu characters, %zu bytes): %d at %d, expected %d at %d\n", (int) length, hex, length, outSize,
+                   result, errorPos, expectedResult, expectedPos);
+            CHECK(false);
+            return;
+        }
+    }
+}
+
+//Pixel decoding: partial pixels, capacity and the byte order of CRGB
+void CheckHexDecodePixels()
+{
+    uint8_t rgb[6];
+    int errorPos = -1;
+
+    CHECK_EQUAL(2, HexDecodePixels("FF8000000aF0", 12, rgb, 2, &errorPos));
+    CHECK_EQUAL(0xFF, rgb[0]);
+    CHECK_EQUAL(0x80, rgb[1]);
+    CHECK_EQUAL(0x00, rgb[2]);
+    CHECK_EQUAL(0x0A, rgb[4]);
+    CHECK_EQUAL(0xF0, rgb[5]);
+
+    CHECK_EQUAL(-1, HexDecodePixels("FF8000000a", 10, rgb, 2, &errorPos));
+    CHECK_EQUAL(6, errorPos);
+
+    CHECK_EQUAL(-1, HexDecodePixels("FF8000000aF0", 12, rgb, 1, &errorPos));
+    CHECK_EQUAL(6, errorPos);
+
+    CHECK_EQUAL(-1, HexDecodePixels("FF80000z0aF0", 12, rgb, 2, &errorPos));
+    CHECK_EQUAL(7, errorPos);
+}
+
+//Previous path: one substring and one strtol per pixel (HexStrToInt)
+int SubstringDecodePixels(const std::string &hex, uint8_t *rgb)
+{
+    int count = hex.length() / 6;
+
+    for (int i = 0; i < count; i++)
+    {
+        std::string pixel = hex.substr(i * 6, 6);
+        char buffer[7];
+        strcpy(buffer, pixel.c_str());
+
+        long value = strtol(buffer, NULL, 16);
+        rgb[i * 3] = value >> 16;
+        rgb[i * 3 + 1] = value >> 8;
+        rgb[i * 3 + 2] = value;
+    }
+
+    return count;
+}
+
+//Times a 16x16 image with both paths
+void BenchmarkHexDecode()
+{
+    std::string hex;
+    uint32_t rng = 7;
+
+    for (int i = 0; i < 16 * 16 * 6; i++)
+    {
+        rng = rng * 1103515245u + 12345u;
+        hex += "0123456789ABCDEF"[(rng >> 16) & 0x0F];
+    }
+
+    uint8_t rgb[16 * 16 * 3], expected[16 * 16 * 3];
+
+    double bulk = BenchmarkMicros(20000, [&] {
+        benchSink += HexDecodePixels(hex.c_str(), hex.length(), rgb, 16 * 16);
+    });
+
+    double substring = BenchmarkMicros(20000, [&] {
+        benchSink += SubstringDecodePixels(hex, expected);
+    });
+
+    printf("16x16 image: bulk %.2f us, substring + strtol %.2f us (%.1fx)\n", bulk, substring, substring / bulk);
+
+    CHECK(memcmp(rgb, expected, sizeof(rgb)) == 0);
+    CHECK(bulk < substring);
+}
+
+int main()
+{
+    FuzzHexDecode();
+    CheckHexDecodePixels();
+    BenchmarkHexDecode();
+
+    return TestResult();
+}
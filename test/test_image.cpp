@@ -0,0 +1,129 @@
+//+--------------------------------------------------------------------------
+//
+// File:        test_image.cpp
+//
+// Description: Checks the stored image decoder (ledimage) on palette and
+//              run-length images, that forged headers whose size would
+//              wrap a 32-bit size_t are rejected instead of decoding to an
+//              empty image, and that the bundled images decode into a
+//              buffer sized from their header, as the sprite loader does.
+//
+// History:     2026-10-18    PP Laplante   Created
+//
+//
+//---------------------------------------------------------------------------
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <string>
+#include <Arduino.h>
+#include <FastLED.h>
+#include <testutils.h>
+#include <ledimage.h>
+
+CRGB imagePixels[LED_IMAGE_MAX_PIXELS];
+
+//Decodes a string image into imagePixels, returns whether it was accepted
+bool DecodeTestImage(const char *data, LedImage &image, size_t capacity = LED_IMAGE_MAX_PIXELS)
+{
+    image = { 0, 0, imagePixels };
+    int errorPos = 0;
+
+    return DecodeLEDImage(data, strlen(data), image, capacity, &errorPos);
+}
+
+//Palette and run images decode to their header size
+void CheckIndexedImages()
+{
+    LedImage image;
+
+    //2x2, 2 colours, one digit per pixel
+    CHECK(DecodeTestImage("@P2,2,2;000000FF8000" "0110", image));
+    CHECK_EQUAL(2, image.width);
+    CHECK_EQUAL(2, image.height);
+    CHECK(imagePixels[1] == CRGB(0xFF, 0x80, 0x00));
+    CHECK(imagePixels[3] == CRGB::Black);
+
+    //3x1: a run of 2 of colour 1 then 1 of colour 0
+    CHECK(DecodeTestImage("@R3,1,2;000000FF8000" "0101" "0000", image));
+    CHECK_EQUAL(3, image.width);
+    CHECK(imagePixels[1] == CRGB(0xFF, 0x80, 0x00));
+    CHECK(imagePixels[2] == CRGB::Black);
+
+    //larger than the buffer
+    CHECK(!DecodeTestImage("@P2,2,2;000000FF8000" "0110", image, 3));
+}
+
+//Sizes whose product wraps a 32-bit size_t to 0 or a small value
+void CheckForgedImageHeaders()
+{
+    LedImage image;
+
+    CHECK(!DecodeTestImage("@P65536,65536,1;000000", image));           //2^32: 0 in 32 bits
+    CHECK(!DecodeTestImage("@R65536,65536,1;000000", image));
+    CHECK(!DecodeTestImage("@P65536,65537,1;000000" "00", image));      //2^32 + 65536: 65536 in 32 bits
+    CHECK(!DecodeTestImage("@P65537,1,1;000000" "00", image));          //width truncated to 1 by uint16_t
+    CHECK(!DecodeTestImage("@P0,16,1;000000", image));
+
+    //the raw length does not wrap either: the file length when it does not fit a size_t
+    const char *forged = "@P65536,65536,1;000000";
+    uint64_t raw = 65536ULL * 65536 * 6;
+    CHECK((uint64_t) GetLEDImageRawLength(forged, strlen(forged), 22) == ((raw <= SIZE_MAX) ? raw : 22));
+}
+
+//Loads a bundled image like LoadLEDSpriteImage: buffer sized by GetLEDImagePixelCount
+void CheckBundledImage(const char *name, int width, int height)
+{
+    std::string path = std::string(LED_TEST_DATA_DIR "/images/") + name;
+    FILE *file = fopen(path.c_str(), "rb");
+    CHECK(file != NULL);
+    if (file == NULL)
+        return;
+
+    std::string data;
+    char buffer[1024];
+    size_t n;
+    while ((n = fread(buffer, 1, sizeof(buffer), file)) > 0)
+        data.append(buffer, n);
+    fclose(file);
+
+    //stored compressed: far fewer characters than 6 per pixel
+    size_t capacity = GetLEDImagePixelCount(data.c_str(), data.length());
+    CHECK_EQUAL(width * height, capacity);
+    CHECK(data.length() / 6 + 1 < capacity);
+
+    CRGB *pixels = (CRGB *) malloc(capacity * sizeof(CRGB));
+    LedImage image = { 0, 0, pixels };
+    int errorPos = 0;
+
+    CHECK(DecodeLEDImage(data.c_str(), data.length(), image, capacity, &errorPos));
+    CHECK_EQUAL(width, image.width);
+    CHECK_EQUAL(height, image.height);
+
+    free(pixels);
+}
+
+//Pixel counts from the headers
+void CheckImagePixelCounts()
+{
+    CHECK_EQUAL(6, GetLEDImagePixelCount("@P3,2,1;000000", 14));
+    CHECK_EQUAL(6, GetLEDImagePixelCount("@R3,2,1;000000", 14));
+    CHECK_EQUAL(4, GetLEDImagePixelCount("@I2,2;", 6));
+    CHECK_EQUAL(2, GetLEDImagePixelCount("000000FFFFFF", 12));
+    CHECK_EQUAL(0, GetLEDImagePixelCount("@P65536,65536,1;000000", 22));
+    CHECK_EQUAL(0, GetLEDImagePixelCount("@P65,64,1;000000", 16));
+    CHECK_EQUAL(0, GetLEDImagePixelCount("@P16,", 5));
+}
+
+int main()
+{
+    CheckIndexedImages();
+    CheckForgedImageHeaders();
+    CheckImagePixelCounts();
+    const char *bundled[] = { "LOZ_Fire.dat", "LOZ_Link.dat", "LOZ_OldMan.dat", "LOZ_Rupies1.dat",
+                              "LOZ_Rupies5.dat", "LOZ_Sword.dat", "LOZ_Zelda.dat" };
+    for (const char *name : bundled)
+        CheckBundledImage(name, 16, 16);
+
+    return TestResult();
+}
@@ -0,0 +1,220 @@
+//+--------------------------------------------------------------------------
+//
+// File:        test_imagepack.cpp
+//
+// Description: Checks the image pack reader (imagepack) on packs laid out
+//              like tools/mkimgpack.py writes them, mapped from a file, and
+//              that corrupted indexes are rejected when the pack is opened
+//              instead of being read past the end of the partition.
+//
+// History:     2026-10-18    PP Laplante   Created
+//
+//
+//---------------------------------------------------------------------------
+#include <stdint.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <unistd.h>
+#include <vector>
+#include <testutils.h>
+#include <imagepack.h>
+
+#define PACK_HEADER_SIZE    16
+#define PACK_ENTRY_SIZE     40
+
+//Image of a test pack
+struct TestPackImage
+{
+    const char  *name;
+    uint16_t    width;
+    uint16_t    height;
+    uint16_t    frames;
+    bool        animated;
+};
+
+void Write16(std::vector<uint8_t> &data, size_t at, uint16_t value)
+{
+    data[at] = value;
+    data[at + 1] = value >> 8;
+}
+
+void Write32(std::vector<uint8_t> &data, size_t at, uint32_t value)
+{
+    for (int i = 0; i < 4; i++)
+        data[at + i] = value >> (i * 8);
+}
+
+//Builds a pack like mkimgpack.py: pixel n of frame f is (n, f, 0xA5), durations 100ms * (f + 1)
+std::vector<uint8_t> BuildTestPack(const TestPackImage *images, int count)
+{
+    std::vector<uint8_t> data(PACK_HEADER_SIZE + count * PACK_ENTRY_SIZE);
+    memcpy(&data[0], "LIPK", 4);
+    Write16(data, 4, IMAGE_PACK_VERSION);
+    Write16(data, 6, count);
+
+    for (int i = 0; i < count; i++)
+    {
+        const TestPackImage &image = images[i];
+        size_t entry = PACK_HEADER_SIZE + i * PACK_ENTRY_SIZE;
+        uint32_t durations = 0;
+
+        if (image.animated)
+        {
+            durations = data.size();
+            for (int f = 0; f < image.frames; f++)
+            {
+                data.push_back((uint8_t) (100 * (f + 1)));
+                data.push_back((uint8_t) ((100 * (f + 1)) >> 8));
+            }
+        }
+
+        while (data.size() % 4 != 0)
+            data.push_back(0);
+
+        uint32_t pixels = data.size();
+        for (int f = 0; f < image.frames; f++)
+        {
+            for (int n = 0; n < image.width * image.height; n++)
+            {
+                data.push_back((uint8_t) n);
+                data.push_back((uint8_t) f);
+                data.push_back(0xA5);
+            }
+        }
+
+        strncpy((char *) &data[entry], image.name, IMAGE_PACK_NAME);
+        Write16(data, entry + 24, image.width);
+        Write16(data, entry + 26, image.height);
+        Write16(data, entry + 28, image.frames);
+        Write32(data, entry + 32, durations);
+        Write32(data, entry + 36, pixels);
+    }
+
+    Write32(data, 8, data.size());
+    return data;
+}
+
+const TestPackImage testImages[] =
+{
+    { "heart", 16, 16, 1, false },
+    { "walk_cycle", 8, 4, 3, true },
+};
+
+//A valid pack, mapped from a file
+void CheckImagePackFile()
+{
+    std::vector<uint8_t> data = BuildTestPack(testImages, 2);
+
+    char path[] = "/tmp/imgpackXXXXXX";
+    int fd = mkstemp(path);
+    CHECK(fd >= 0);
+    CHECK(write(fd, data.data(), data.size()) == (ssize_t) data.size());
+    close(fd);
+
+    ImagePack pack;
+    CHECK(MapImagePackFile(path, pack));
+    unlink(path);
+    if (pack.data == NULL)
+        return;
+
+    CHECK_EQUAL(2, pack.count);
+    CHECK_EQUAL(data.size(), pack.size);
+    CHECK_EQUAL(0, FindImagePackEntry(pack, "heart"));
+    CHECK_EQUAL(1, FindImagePackEntry(pack, "walk_cycle"));
+    CHECK_EQUAL(-1, FindImagePackEntry(pack, "walk"));
+    CHECK_EQUAL(-1, FindImagePackEntry(pack, "walk_cycle_and_more_than_24"));
+
+    ImagePackEntry entry;
+    CHECK(GetImagePackEntry(pack, 0, entry));
+    CHECK(strcmp(entry.name, "heart") == 0);
+    CHECK_EQUAL(16, entry.width);
+    CHECK(entry.durations == NULL);
+    CHECK_EQUAL(0, GetImagePackDuration(entry, 0));
+    CHECK_EQUAL(255, GetImagePackFrame(entry, 0)[255 * 3]);
+
+    CHECK(GetImagePackEntry(pack, 1, entry));
+    CHECK_EQUAL(3, entry.frames);
+    CHECK_EQUAL(200, GetImagePackDuration(entry, 1));
+    CHECK_EQUAL(100, GetImagePackDuration(entry, 3));
+    const uint8_t *frame = GetImagePackFrame(entry, 2);
+    CHECK_EQUAL(31, frame[31 * 3]);
+    CHECK_EQUAL(2, frame[31 * 3 + 1]);
+    CHECK_EQUAL(0xA5, frame[31 * 3 + 2]);
+    CHECK(frame + 8 * 4 * 3 <= pack.data + pack.size);
+
+    CHECK(!GetImagePackEntry(pack, 2, entry));
+    CHECK(!GetImagePackEntry(pack, -1, entry));
+}
+
+//Opens a copy of a valid pack with one field of 2 or 4 bytes overwritten (0: none), returns whether it was accepted
+bool OpenCorruptedPack(size_t at, uint32_t value, int bytes)
+{
+    static std::vector<uint8_t> data;
+    data = BuildTestPack(testImages, 2);
+
+    if (bytes == 2)
+        Write16(data, at, value);
+    else if (bytes == 4)
+        Write32(data, at, value);
+
+    ImagePack pack;
+    bool opened = OpenImagePack(data.data(), data.size(), pack);
+
+    //a rejected pack must not be usable
+    if (!opened)
+        CHECK(pack.data == NULL && pack.count == 0);
+
+    return opened;
+}
+
+//Corrupted headers and indexes are rejected when opening
+void CheckCorruptedImagePacks()
+{
+    size_t second = PACK_HEADER_SIZE + PACK_ENTRY_SIZE;
+
+    CHECK(OpenCorruptedPack(0, 0, 0));                          //unchanged
+
+    CHECK(!OpenCorruptedPack(0, 0x4B50494D, 4));                //magic
+    CHECK(!OpenCorruptedPack(4, 2, 2));                         //version
+    CHECK(!OpenCorruptedPack(6, 1000, 2));                      //index past the pack
+    CHECK(!OpenCorruptedPack(8, 0x10000000, 4));                //pack larger than the partition
+
+    //32768 x 32768 x 3 bytes x 4 frames is 3 << 32: 0 in a 32-bit size_t
+    {
+        std::vector<uint8_t> data = BuildTestPack(testImages, 2);
+        Write16(data, second + 24, 32768);
+        Write16(data, second + 26, 32768);
+        Write16(data, second + 28, 4);
+
+        ImagePack pack;
+        CHECK(!OpenImagePack(data.data(), data.size(), pack));
+    }
+
+    //images over the decoded image limit are rejected even when their pixels are in the pack
+    {
+        const TestPackImage largest[] = { { "largest", 64, LED_IMAGE_MAX_PIXELS / 64, 1, false } };
+        const TestPackImage tooLarge[] = { { "too_large", 64, LED_IMAGE_MAX_PIXELS / 64 + 1, 1, false } };
+        std::vector<uint8_t> data;
+        ImagePack pack;
+
+        data = BuildTestPack(largest, 1);
+        CHECK(OpenImagePack(data.data(), data.size(), pack));
+        data = BuildTestPack(tooLarge, 1);
+        CHECK(!OpenImagePack(data.data(), data.size(), pack));
+    }
+
+    CHECK(!OpenCorruptedPack(second + 24, 0, 2));               //empty image
+    CHECK(!OpenCorruptedPack(second + 28, 0, 2));               //no frames
+    CHECK(!OpenCorruptedPack(second + 28, 4, 2));               //frames past the end
+    CHECK(!OpenCorruptedPack(second + 36, 0xFFFFFFF0, 4));      //pixels past the end
+    CHECK(!OpenCorruptedPack(second + 32, 0xFFFFFFFF, 4));      //durations past the end
+}
+
+int main()
+{
+    CheckImagePackFile();
+    CheckCorruptedImagePacks();
+
+    return TestResult();
+}
@@ -0,0 +1,132 @@
+//+--------------------------------------------------------------------------
+//
+// File:        test_life.cpp
+//
+// Description: Checks the bit-packed Game of Life (lifeutils) against a
+//              naive neighbour-count implementation over random soups of
+//              every grid size the effect supports, and benchmarks both.
+//
+// History:     2026-10-18    PP Laplante   Created
+//
+//
+//---------------------------------------------------------------------------
+#include <stdint.h>
+#include <testutils.h>
+#include <lifeutils.h>
+
+#define LIFE_TEST_GENERATIONS   64
+
+volatile uint32_t benchSink = 0;            //keeps the results alive
+
+//Reference generation: counts the 8 wrap-around neighbours of every cell
+void NaiveLifeStep(const uint32_t *rows, uint32_t *next, int width, int height)
+{
+    for (int y = 0; y < height; y++)
+    {
+        next[y] = 0;
+
+        for (int x = 0; x < width; x++)
+        {
+            int neighbours = 0;
+
+            for (int dy = -1; dy <= 1; dy++)
+                for (int dx = -1; dx <= 1; dx++)
+                    if (dx != 0 || dy != 0)
+                        neighbours += (rows[(y + dy + height) % height] >> ((x + dx + width) % width)) & 1;
+
+            bool alive = (rows[y] >> x) & 1;
+            if (neighbours == 3 || (alive && neighbours == 2))
+                next[y] |= 1u << x;
+        }
+    }
+}
+
+//Runs both implementations side by side from a random soup
+void CheckLifeGrid(int width, int height, uint32_t seed)
+{
+    uint32_t rows[LIFE_MAX_WIDTH], next[LIFE_MAX_WIDTH];
+    uint32_t naive[LIFE_MAX_WIDTH], naiveNext[LIFE_MAX_WIDTH];
+    uint32_t rng = seed;
+
+    LifeSeed(rows, width, height, rng, 35);
+    for (int y = 0; y < height; y++)
+        naive[y] = rows[y];
+
+    for (int g = 0; g < LIFE_TEST_GENERATIONS; g++)
+    {
+        LifeStep(rows, next, width, height);
+        NaiveLifeStep(naive, naiveNext, width, height);
+
+        int naivePopulation = 0;
+        for (int y = 0; y < height; y++)
+        {
+            rows[y] = next[y];
+            naive[y] = naiveNext[y];
+            naivePopulation += __builtin_popcount(naive[y]);
+
+            if (rows[y] != naive[y])
+            {
+                printf("%dx%d seed %u generation %d row %d: %08X, expected %08X\n", width, height, seed, g, y, rows[y], naive[y]);
+                CHECK(rows[y] == naive[y]);
+                return;
+            }
+        }
+
+        CHECK_EQUAL(naivePopulation, LifePopulation(rows, height));
+    }
+}
+
+//A glider comes back to its shape, moved one cell diagonally, every 4 generations
+void CheckLifeGlider()
+{
+    uint32_t rows[8] = { 0x2, 0x4, 0x7, 0, 0, 0, 0, 0 };
+    uint32_t next[8];
+
+    for (int g = 0; g < 4; g++)
+    {
+        LifeStep(rows, next, 8, 8);
+        for (int y = 0; y < 8; y++)
+            rows[y] = next[y];
+    }
+
+    CHECK_EQUAL(0x0, rows[0]);
+    CHECK_EQUAL(0x4, rows[1]);
+    CHECK_EQUAL(0x8, rows[2]);
+    CHECK_EQUAL(0xE, rows[3]);
+}
+
+//Times one generation of both implementations
+void BenchmarkLife(int width, int height, int iterations)
+{
+    uint32_t rows[LIFE_MAX_WIDTH], next[LIFE_MAX_WIDTH];
+    uint32_t rng = 1;
+    LifeSeed(rows, width, height, rng, 35);
+
+    double packed = BenchmarkMicros(iterations, [&] {
+        LifeStep(rows, next, width, height);
+        benchSink += next[0];
+    });
+
+    double naive = BenchmarkMicros(iterations, [&] {
+        NaiveLifeStep(rows, next, width, height);
+        benchSink += next[0];
+    });
+
+    printf("%dx%d generation: packed %.3f us, naive %.3f us (%.0fx)\n", width, height, packed, naive, naive / packed);
+
+    CHECK(packed < naive);
+}
+
+int main()
+{
+    CheckLifeGlider();
+
+    for (int height = 3; height <= 32; height++)
+        for (int width = 3; width <= LIFE_MAX_WIDTH; width++)
+            CheckLifeGrid(width, height, width * 131 + height);
+
+    BenchmarkLife(16, 16, 100000);
+    BenchmarkLife(32, 32, 50000);
+
+    return TestResult();
+}
@@ -0,0 +1,113 @@
+//+--------------------------------------------------------------------------
+//
+// File:        test_parallel.cpp
+//
+// Description: Checks the parallel for over rows (parallelutils): each row
+//              is processed exactly once, the first half on the helper, and
+//              the noise effect split in row jobs (NoiseFillRows, called
+//              like DrawLEDNoiseRows does) matches a whole NoiseFill.
+//
+// History:     2026-10-18    PP Laplante   Created
+//
+//
+//---------------------------------------------------------------------------
+#include <string.h>
+#include <thread>
+#include <testutils.h>
+#include <ledconfig.h>
+#include <fxutils.h>
+#include <parallelutils.h>
+
+#define PARALLEL_MAX_ROWS   64
+
+//Rows seen by a counting job
+struct RowCounts
+{
+    int             rows[PARALLEL_MAX_ROWS];
+    std::thread::id threads[PARALLEL_MAX_ROWS];
+};
+
+//Noise job context, same arguments as DrawLEDNoiseRows
+struct NoiseRows
+{
+    uint8_t         *values;
+    int             width;
+    uint16_t        t;
+};
+
+void CountRows(int first, int last, void *context)
+{
+    RowCounts &counts = *(RowCounts *) context;
+
+    for (int y = first; y < last; y++)
+    {
+        counts.rows[y]++;
+        counts.threads[y] = std::this_thread::get_id();
+    }
+}
+
+void NoiseRowsJob(int first, int last, void *context)
+{
+    const NoiseRows &job = *(const NoiseRows *) context;
+
+    NoiseFillRows(job.values, job.width, first, last, job.t * 3, job.t * 2, job.t * LED_NOISE_SPEED, LED_NOISE_SCALE);
+}
+
+//Every row exactly once, the first half on the helper when the job is large enough
+void CheckRowSplit()
+{
+    for (int rows = 1; rows <= PARALLEL_MAX_ROWS; rows++)
+    {
+        RowCounts counts = {};
+        ParallelForRows(rows, CountRows, &counts);
+
+        for (int y = 0; y < rows; y++)
+            CHECK_EQUAL(1, counts.rows[y]);
+        for (int y = rows; y < PARALLEL_MAX_ROWS; y++)
+            CHECK_EQUAL(0, counts.rows[y]);
+
+        bool helper = counts.threads[0] != std::this_thread::get_id();
+        CHECK(helper == (rows >= PARALLEL_MIN_ROWS));
+        CHECK(counts.threads[rows - 1] == std::this_thread::get_id());
+    }
+}
+
+//Split noise matches the whole grid, including the y offset of the second half and uint16 wrap
+void CheckNoiseRows(int width, int height)
+{
+    uint8_t whole[PARALLEL_MAX_ROWS * PARALLEL_MAX_ROWS];
+    uint8_t split[PARALLEL_MAX_ROWS * PARALLEL_MAX_ROWS];
+
+    for (uint32_t frame = 0; frame < 600; frame++)
+    {
+        //around 0 and around the wrap of t * LED_NOISE_SPEED and t * 3
+        uint16_t t = (frame < 300) ? frame : 65536 - 600 + frame;
+
+        NoiseFill(whole, width, height, t * 3, t * 2, t * LED_NOISE_SPEED, LED_NOISE_SCALE);
+
+        memset(split, 0, sizeof(split));
+        NoiseRows job = { split, width, t };
+        ParallelForRows(height, NoiseRowsJob, &job);
+
+        if (memcmp(whole, split, width * height) != 0)
+        {
+            printf("%dx%d noise differs at t %u\n", width, height, t);
+            CHECK(false);
+            return;
+        }
+    }
+}
+
+int main()
+{
+    InitParallel();
+
+    CheckRowSplit();
+
+    CheckNoiseRows(16, 16);
+    CheckNoiseRows(32, 32);
+    for (int height = 1; height <= 33; height += 4)
+        CheckNoiseRows(7, height);
+
+    return TestResult();
+}
@@ -0,0 +1,93 @@
+//+--------------------------------------------------------------------------
+//
+// File:        test_pipeline.cpp
+//
+// Description: Checks the pipelined output (ledpipeline) with a driver
+//              sleeping like a strip transfer: every frame reaches the
+//              driver once and in order, the driver never sees a frame being
+//              drawn, and computing the next frame overlaps the transfer.
+//
+// History:     2026-10-18    PP Laplante   Created
+//
+//
+//---------------------------------------------------------------------------
+#include <atomic>
+#include <Arduino.h>
+#include <FastLED.h>
+#include <testutils.h>
+#include <ledpipeline.h>
+
+#define PIPELINE_FRAMES         20
+#define PIPELINE_DRIVER_MS      8           //WS2812 transfer of about 260 LEDs
+#define PIPELINE_COMPUTE_MS     6           //drawing a frame
+
+//Global variables
+std::atomic<int> driverFrames(0);           //frames seen by the driver
+std::atomic<int> driverErrors(0);           //frames out of order or torn
+
+//Simulated strip: checks the frame is complete and stays unchanged for the whole transfer
+void SleepingDriver(const CRGB *buffer, int count)
+{
+    uint8_t frame = buffer[0].r;
+
+    delay(PIPELINE_DRIVER_MS);
+
+    if (frame != (uint8_t) (driverFrames + 1))
+        driverErrors++;
+
+    for (int i = 0; i < count; i++)
+    {
+        if (buffer[i] != CRGB(frame, 0, 0))
+        {
+            driverErrors++;
+            break;
+        }
+    }
+
+    driverFrames++;
+}
+
+//Draws frame n into the back buffer, half before and half after the compute time
+void DrawFrame(int n)
+{
+    CRGB *buffer = GetLEDPipelineBackBuffer();
+
+    for (int i = 0; i < LED_NUM_LEDS / 2; i++)
+        buffer[i] = CRGB(n, 0, 0);
+
+    delay(PIPELINE_COMPUTE_MS);
+
+    for (int i = LED_NUM_LEDS / 2; i < LED_NUM_LEDS; i++)
+        buffer[i] = CRGB(n, 0, 0);
+}
+
+int main()
+{
+    InitLEDPipeline(SleepingDriver);
+
+    unsigned long start = micros();
+
+    for (int n = 1; n <= PIPELINE_FRAMES; n++)
+    {
+        DrawFrame(n);
+        SubmitLEDPipelineFrame();
+    }
+
+    WaitLEDPipeline();
+    unsigned long elapsed = micros() - start;
+
+    //inline output would take the sum of both, pipelined about the driver time alone
+    unsigned long inlineTime = PIPELINE_FRAMES * (PIPELINE_DRIVER_MS + PIPELINE_COMPUTE_MS) * 1000UL;
+
+    printf("%d frames: %lu us pipelined, %lu us inline, %lu us waiting for the driver\n",
+           PIPELINE_FRAMES, elapsed, inlineTime, GetLEDPipelineWaitTime());
+
+    CHECK_EQUAL(PIPELINE_FRAMES, GetLEDPipelineFrames());
+    CHECK_EQUAL(PIPELINE_FRAMES, driverFrames.load());
+    CHECK_EQUAL(0, driverErrors.load());
+    CHECK_EQUAL(PIPELINE_FRAMES, GetLEDPipelineFrontBuffer()[0].r);
+    CHECK(GetLEDPipelineDriverTime() >= PIPELINE_DRIVER_MS * 1000UL);
+    CHECK(elapsed < inlineTime * 85 / 100);
+
+    return TestResult();
+}
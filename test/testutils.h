@@ -0,0 +1,44 @@
+#ifndef testutils_h
+#define testutils_h
+
+#include <stdio.h>
+#include <chrono>
+
+//Minimal checks for the host tests: failures are counted and reported, the exit code tells ctest
+
+static int testFailures = 0;
+
+//Checks a condition, reports the failed expression and where
+#define CHECK(condition) \
+    do { if (!(condition)) { testFailures++; printf("%s:%d: CHECK(%s) failed\n", __FILE__, __LINE__, #condition); } } while (0)
+
+//Checks two integer values are equal, reports both
+#define CHECK_EQUAL(expected, actual) \
+    do { long long e_ = (long long) (expected), a_ = (long long) (actual); \
+         if (e_ != a_) { testFailures++; printf("%s:%d: %s == %lld, expected %lld\n", __FILE__, __LINE__, #actual, a_, e_); } } while (0)
+
+//Exit code of a test: 0 if every check passed
+static inline int TestResult()
+{
+    if (testFailures != 0)
+        printf("%d check(s) failed\n", testFailures);
+    else
+        printf("OK\n");
+
+    return testFailures != 0;
+}
+
+//Gets the time of a call averaged over iterations, in us
+template <typename Function>
+double BenchmarkMicros(int iterations, Function function)
+{
+    auto start = std::chrono::steady_clock::now();
+
+    for (int i = 0; i < iterations; i++)
+        function();
+
+    std::chrono::duration<double, std::micro> elapsed = std::chrono::steady_clock::now() - start;
+    return elapsed.count() / iterations;
+}
+
+#endif
@@ -0,0 +1,291 @@
+#+--------------------------------------------------------------------------
+#
+# File:        imgconv.py
+#
+# Description: Converts PNG, GIF (animated or not) and other images readable
+#              by Pillow into the image store format of the device, and
+#              optionally uploads them. Decoding, resizing and palette
+#              quantisation are done here so the firmware needs no image
+#              codec.
+#
+#              python tools/imgconv.py images/*.png --out data/images
+#              python tools/imgconv.py anim.gif --push 192.168.1.50
+#
+#              Requires Pillow (pip install pillow).
+#
+# History:     2026-10-18    PP Laplante   Created
+#
+#
+#---------------------------------------------------------------------------
+import argparse
+import os
+import re
+import sys
+import urllib.parse
+import urllib.request
+
+try:
+    from PIL import Image, ImageSequence
+except ImportError:
+    sys.exit('Pillow is required: pip install pillow')
+
+PLATFORMIO_INI = os.path.join(os.path.dirname(os.path.abspath(__file__)), '..', 'platformio.ini')
+
+#limits of the firmware (ledimage.h, ledanim.h)
+LED_IMAGE_MAX_PIXELS = 4096
+LED_ANIM_MAX_PIXELS = 1024
+
+NAME_PATTERN = re.compile(r'[^a-zA-Z0-9_]')
+NAME_MAX = 24
+
+
+#Reads a -D flag of the build (e.g. LED_MATRIX_WIDTH) from platformio.ini
+def read_build_flag(name, default):
+    try:
+        with open(PLATFORMIO_INI) as f:
+            match = re.search(r'-D\s*' + name + r'=(\d+)', f.read())
+            if match:
+                return int(match.group(1))
+    except OSError:
+        pass
+    return default
+
+
+#Gets the pixels of a frame as (r, g, b) tuples in row order
+def frame_pixels(frame, args):
+    rgba = frame.convert('RGBA')
+
+    #transparent pixels over the background colour
+    background = Image.new('RGBA', rgba.size, args.background + (255,))
+    rgb = Image.alpha_composite(background, rgba).convert('RGB')
+
+    if args.fit != 'none' and rgb.size != (args.width, args.height):
+        resample = Image.NEAREST if args.resample == 'nearest' else Image.LANCZOS
+        if args.fit == 'stretch':
+            rgb = rgb.resize((args.width, args.height), resample)
+        else:
+            #contain: keep the aspect ratio, black borders
+            scale = min(args.width / rgb.width, args.height / rgb.height)
+            size = (max(1, round(rgb.width * scale)), max(1, round(rgb.height * scale)))
+            fitted = Image.new('RGB', (args.width, args.height), args.background)
+            fitted.paste(rgb.resize(size, resample), ((args.width - size[0]) // 2, (args.height - size[1]) // 2))
+            rgb = fitted
+
+    pixels = rgb_tuples(rgb)
+
+    #strip order, for firmware built without LED_MATRIX_INTERLACED: even rows run right to left
+    if args.serpentine:
+        width = rgb.width
+        for y in range(0, rgb.height, 2):
+            pixels[y * width:(y + 1) * width] = pixels[y * width:(y + 1) * width][::-1]
+
+    return rgb.width, rgb.height, pixels
+
+
+#Reduces the colours of a set of frames to one shared palette
+def quantize_frames(frames, width, colors):
+    if colors <= 0:
+        return frames
+
+    #quantise all frames together so they share a palette
+    data = bytes(v for p in frames for c in p for v in c)
+    sheet = Image.frombytes('RGB', (width, len(data) // 3 // width), data)
+    sheet = sheet.quantize(colors, dither=Image.Dither.NONE).convert('RGB')
+    data = rgb_tuples(sheet)
+
+    result = []
+    pos = 0
+    for p in frames:
+        result.append(data[pos:pos + len(p)])
+        pos += len(p)
+    return result
+
+
+#Gets the pixels of an RGB image as (r, g, b) tuples
+def rgb_tuples(image):
+    data = image.tobytes()
+    return [tuple(data[i:i + 3]) for i in range(0, len(data), 3)]
+
+
+def hex_pixels(pixels):
+    return ''.join('%02X%02X%02X' % p for p in pixels)
+
+
+#Gets whether the device infers the size of a headerless image (DecodeLEDImage)
+def can_omit_header(width, height, matrix_width):
+    count = width * height
+    side = int(count ** 0.5)
+    while side * side > count:
+        side -= 1
+    while (side + 1) * (side + 1) <= count:
+        side += 1
+    if side * side == count:
+        return width == side
+    return width == matrix_width
+
+
+#Encodes a still image in the smallest representation (same choice as EncodeLEDImage)
+def encode_still(width, height, pixels, matrix_width):
+    candidates = [('' if can_omit_header(width, height, matrix_width) else '@I%d,%d;' % (width, height)) + hex_pixels(pixels)]
+
+    palette = list(dict.fromkeys(pixels))
+    if len(palette) <= 256:
+        index = {c: i for i, c in enumerate(palette)}
+        indices = [index[c] for c in pixels]
+        header = '%d,%d,%d;' % (width, height, len(palette)) + hex_pixels(palette)
+
+        #palette indices, one digit each up to 16 colours (padded to an even count)
+        if len(palette) <= 16:
+            body = ''.join('%X' % i for i in indices) + ('0' if len(indices) % 2 else '')
+        else:
+            body = ''.join('%02X' % i for i in indices)
+        candidates.append('@P' + header + body)
+
+        #runs of (length - 1, index)
+        runs = []
+        i = 0
+        while i < len(indices):
+            run = 1
+            while i + run < len(indices) and run < 256 and indices[i + run] == indices[i]:
+                run += 1
+            runs.append('%02X%02X' % (run - 1, indices[i]))
+            i += run
+        candidates.append('@R' + header + ''.join(runs))
+
+    return min(candidates, key=len)
+
+
+#Encodes an animation, delta-encoded (ledanim.h) when that is smaller
+def encode_animation(width, height, frames, durations, keyframe):
+    header = '%d,%d,%d;' % (width, height, len(frames))
+    full = '@A' + header + ''.join('%04X' % d + hex_pixels(p) for d, p in zip(durations, frames))
+
+    records = []
+    for n, (d, p) in enumerate(zip(durations, frames)):
+        if n == 0 or (keyframe > 0 and n % keyframe == 0):
+            records.append('K%04X' % d + hex_pixels(p))
+            continue
+
+        #skip/run pairs against the previous frame
+        previous = frames[n - 1]
+        pairs = []
+        i = 0
+        while i < len(p):
+            skip = 0
+            while i < len(p) and skip < 255 and p[i] == previous[i]:
+                skip += 1
+                i += 1
+            run = 0
+            while i + run < len(p) and run < 255 and p[i + run] != previous[i + run]:
+                run += 1
+            if run == 0 and i >= len(p):
+                break
+            pairs.append('%02X%02X' % (skip, run) + hex_pixels(p[i:i + run]))
+            i += run
+        delta = ''.join(pairs)
+        records.append('D%04X%06X' % (d, len(delta)) + delta)
+
+    delta = '@D' + header + ''.join(records)
+    return delta if len(delta) < len(full) else full
+
+
+#Converts one file, returns (name, data)
+def convert(path, args):
+    image = Image.open(path)
+    frames = []
+    durations = []
+
+    for frame in ImageSequence.Iterator(image):
+        width, height, pixels = frame_pixels(frame, args)
+        frames.append(pixels)
+        durations.append(min(0xFFFF, int(frame.info.get('duration', 100) or 100)))
+
+    frames = quantize_frames(frames, width, args.colors)
+
+    name = NAME_PATTERN.sub('_', os.path.splitext(os.path.basename(path))[0])[:NAME_MAX]
+
+    if len(frames) > 1 and not args.still:
+        if width * height > LED_ANIM_MAX_PIXELS:
+            raise ValueError('%dx%d frames exceed LED_ANIM_MAX_PIXELS (%d)' % (width, height, LED_ANIM_MAX_PIXELS))
+        if args.fps > 0:
+            durations = [1000 // args.fps] * len(frames)
+        return name, encode_animation(width, height, frames, durations, args.keyframe)
+
+    if width * height > LED_IMAGE_MAX_PIXELS:
+        raise ValueError('%dx%d exceeds LED_IMAGE_MAX_PIXELS (%d)' % (width, height, LED_IMAGE_MAX_PIXELS))
+    return name, encode_still(width, height, frames[0], args.matrix_width)
+
+
+#Uploads an image to the device (PUT /api/image, form encoded body)
+def push(host, name, data):
+    url = (host if host.startswith('http') else 'http://' + host).rstrip('/') + '/api/image'
+    body = urllib.parse.urlencode({'imgname': name, 'imgdata': data}).encode('ascii')
+    request = urllib.request.Request(url, data=body, method='PUT',
+                                     headers={'Content-Type': 'application/x-www-form-urlencoded'})
+    with urllib.request.urlopen(request, timeout=30) as response:
+        return response.read().decode('utf-8', 'replace')
+
+
+def parse_color(text):
+    text = text.lstrip('#')
+    return tuple(int(text[i:i + 2], 16) for i in (0, 2, 4))
+
+
+def main():
+    matrix_width = read_build_flag('LED_MATRIX_WIDTH', 16)
+    matrix_height = read_build_flag('LED_MATRIX_HEIGHT', 16)
+
+    parser = argparse.ArgumentParser(description='Converts images to the device image format.')
+    parser.add_argument('files', nargs='+', help='images to convert (PNG, GIF, ...)')
+    parser.add_argument('--out', help='directory receiving the .dat files (default: data/images unless pushing)')
+    parser.add_argument('--push', metavar='HOST', help='upload to the device at HOST')
+    parser.add_argument('--width', type=int, default=matrix_width, help='target width (default: platformio.ini, %(default)s)')
+    parser.add_argument('--height', type=int, default=matrix_height, help='target height (default: platformio.ini, %(default)s)')
+    parser.add_argument('--fit', choices=['stretch', 'contain', 'none'], default='stretch',
+                        help='how images are resized to the target size (none keeps the size, the device scales)')
+    parser.add_argument('--resample', choices=['nearest', 'lanczos'], default='nearest',
+                        help='resizing filter, nearest keeps pixel art sharp')
+    parser.add_argument('--colors', type=int, default=0, help='quantise to at most this many colours (1-256)')
+    parser.add_argument('--serpentine', action='store_true',
+                        help='store in strip order (firmware built without LED_MATRIX_INTERLACED)')
+    parser.add_argument('--background', type=parse_color, default=(0, 0, 0), help='colour under transparent pixels (RRGGBB)')
+    parser.add_argument('--still', action='store_true', help='keep only the first frame of animations')
+    parser.add_argument('--fps', type=int, default=0, help='override the frame durations of animations')
+    parser.add_argument('--keyframe', type=int, default=16,
+                        help='keyframe interval of delta-encoded animations, 0 for the first frame only')
+    args = parser.parse_args()
+
+    args.matrix_width = matrix_width
+    if args.colors > 256:
+        parser.error('--colors must be at most 256')
+    if args.out is None and args.push is None:
+        args.out = os.path.join(os.path.dirname(PLATFORMIO_INI), 'data', 'images')
+
+    failed = 0
+    for path in args.files:
+        try:
+            name, data = convert(path, args)
+        except (OSError, ValueError) as e:
+            print('%s: %s' % (path, e), file=sys.stderr)
+            failed += 1
+            continue
+
+        print('%s -> %s (%d characters, %s)' % (path, name, len(data), data[:2] if data.startswith('@') else 'raw'))
+
+        if args.out:
+            os.makedirs(args.out, exist_ok=True)
+            with open(os.path.join(args.out, name + '.dat'), 'w') as f:
+                f.write(data)
+
+        if args.push:
+            try:
+                print('  ' + push(args.push, name, data))
+            except OSError as e:
+                print('%s: upload failed: %s' % (path, e), file=sys.stderr)
+                failed += 1
+
+    return 1 if failed else 0
+
+
+if __name__ == '__main__':
+    sys.exit(main())
@@ -0,0 +1,213 @@
+#+--------------------------------------------------------------------------
+#
+# File:        mkimgpack.py
+#
+# Description: Builds an image pack (see include/imagepack.h) from a
+#              directory of images: device .dat files (any stored format)
+#              and anything tools/imgconv.py converts. The pack is written
+#              to the "imgpack" partition of partitions_imgpack.csv and
+#              used by the firmware built with LED_IMAGE_PACK=1.
+#
+#              python tools/mkimgpack.py data/images imgpack.bin
+#              esptool.py write_flash 0x340000 imgpack.bin
+#
+# History:     2026-10-18    PP Laplante   Created
+#
+#
+#---------------------------------------------------------------------------
+import argparse
+import os
+import re
+import struct
+import sys
+
+TOOLS_DIR = os.path.dirname(os.path.abspath(__file__))
+PARTITIONS_CSV = os.path.join(TOOLS_DIR, '..', 'partitions_imgpack.csv')
+
+PACK_MAGIC = b'LIPK'
+PACK_VERSION = 1
+PACK_HEADER_SIZE = 16
+PACK_ENTRY_SIZE = 40
+PACK_NAME = 24
+
+IMAGE_EXTENSIONS = ('.png', '.gif', '.bmp', '.jpg', '.jpeg')
+
+
+def hex_rgb(text):
+    data = bytes.fromhex(text)
+    return [tuple(data[i:i + 3]) for i in range(0, len(data), 3)]
+
+
+def parse_header(text, count):
+    end = text.index(';')
+    values = [int(v) for v in text[2:end].split(',')]
+    if len(values) != count:
+        raise ValueError('invalid header ' + text[:end + 1])
+    return values, text[end + 1:]
+
+
+#Decodes a device .dat file (see ledimage.h, ledanim.h), returns (width, height, frames, durations)
+def decode_dat(text, matrix_width):
+    text = text.strip().upper()
+
+    if text.startswith('@P') or text.startswith('@R'):
+        (width, height, colors), body = parse_header(text, 3)
+        palette = hex_rgb(body[:colors * 6])
+        body = bytes.fromhex(body[colors * 6:])
+        count = width * height
+        if text.startswith('@R'):
+            pixels = []
+            for i in range(0, len(body), 2):
+                pixels += [palette[body[i + 1]]] * (body[i] + 1)
+        elif colors <= 16:
+            pixels = [palette[b >> s & 0x0F] for b in body for s in (4, 0)][:count]
+        else:
+            pixels = [palette[b] for b in body]
+        return width, height, [pixels[:count]], None
+
+    if text.startswith('@A') or text.startswith('@D'):
+        (width, height, count), body = parse_header(text, 3)
+        size = width * height * 6
+        frames = []
+        durations = []
+        pos = 0
+        for n in range(count):
+            if text.startswith('@A') or body[pos] == 'K':
+                pos += 0 if text.startswith('@A') else 1
+                durations.append(int(body[pos:pos + 4], 16))
+                frames.append(hex_rgb(body[pos + 4:pos + 4 + size]))
+                pos += 4 + size
+            else:
+                durations.append(int(body[pos + 1:pos + 5], 16))
+                length = int(body[pos + 5:pos + 11], 16)
+                delta = body[pos + 11:pos + 11 + length]
+                pixels = list(frames[-1])
+                i = 0
+                index = 0
+                while i < length:
+                    skip, run = int(delta[i:i + 2], 16), int(delta[i + 2:i + 4], 16)
+                    index += skip
+                    pixels[index:index + run] = hex_rgb(delta[i + 4:i + 4 + run * 6])
+                    index += run
+                    i += 4 + run * 6
+                frames.append(pixels)
+                pos += 11 + length
+        return width, height, frames, durations
+
+    if text.startswith('@I'):
+        (width, height), body = parse_header(text, 2)
+        return width, height, [hex_rgb(body)], None
+
+    #headerless: square, or as wide as the matrix
+    pixels = hex_rgb(text)
+    side = int(len(pixels) ** 0.5)
+    if side * side == len(pixels):
+        return side, side, [pixels], None
+    if len(pixels) % matrix_width == 0:
+        return matrix_width, len(pixels) // matrix_width, [pixels], None
+    raise ValueError('cannot tell the size of a headerless image')
+
+
+#Reads the size of the imgpack partition, 0 if unknown
+def partition_size():
+    try:
+        with open(PARTITIONS_CSV) as f:
+            for line in f:
+                fields = [v.strip() for v in line.split('#')[0].split(',')]
+                if len(fields) >= 5 and fields[0] == 'imgpack':
+                    return int(fields[4], 0)
+    except (OSError, ValueError):
+        pass
+    return 0
+
+
+#Builds the pack from (name, width, height, frames, durations) tuples
+def build_pack(images):
+    index = b''
+    data = b''
+    offset = PACK_HEADER_SIZE + len(images) * PACK_ENTRY_SIZE
+
+    for name, width, height, frames, durations in images:
+        durations_offset = 0
+        if durations and len(frames) > 1:
+            durations_offset = offset + len(data)
+            data += struct.pack('<%dH' % len(durations), *durations)
+
+        #pixels aligned on 4 bytes
+        data += b'\0' * (-(offset + len(data)) % 4)
+        pixels_offset = offset + len(data)
+        data += bytes(v for frame in frames for pixel in frame for v in pixel)
+
+        index += struct.pack('<%dsHHHHII' % PACK_NAME, name.encode('ascii'), width, height, len(frames), 0,
+                             durations_offset, pixels_offset)
+
+    size = offset + len(data)
+    return struct.pack('<4sHHII', PACK_MAGIC, PACK_VERSION, len(images), size, 0) + index + data
+
+
+def main():
+    sys.path.insert(0, TOOLS_DIR)
+    import imgconv
+
+    matrix_width = imgconv.read_build_flag('LED_MATRIX_WIDTH', 16)
+    matrix_height = imgconv.read_build_flag('LED_MATRIX_HEIGHT', 16)
+
+    parser = argparse.ArgumentParser(description='Builds an image pack for the imgpack flash partition.')
+    parser.add_argument('source', help='directory of images (.dat, PNG, GIF, ...)')
+    parser.add_argument('output', help='pack file to write')
+    parser.add_argument('--fit', choices=['stretch', 'contain', 'none'], default='stretch',
+                        help='how converted images are resized to the matrix')
+    parser.add_argument('--colors', type=int, default=0, help='quantise converted images to at most this many colours')
+    args = parser.parse_args()
+
+    #conversion options of imgconv for PNG, GIF, ...
+    options = argparse.Namespace(width=matrix_width, height=matrix_height, fit=args.fit, resample='nearest',
+                                 colors=args.colors, serpentine=False, background=(0, 0, 0), still=False,
+                                 fps=0, keyframe=0, matrix_width=matrix_width)
+
+    images = []
+    for file_name in sorted(os.listdir(args.source)):
+        path = os.path.join(args.source, file_name)
+        stem, extension = os.path.splitext(file_name)
+        name = re.sub(r'[^a-zA-Z0-9_]', '_', stem)[:PACK_NAME]
+
+        try:
+            if extension.lower() == '.dat':
+                with open(path) as f:
+                    text = f.read()
+            elif extension.lower() in IMAGE_EXTENSIONS:
+                name, text = imgconv.convert(path, options)
+            else:
+                continue
+
+            width, height, frames, durations = decode_dat(text, matrix_width)
+            if width * height > imgconv.LED_IMAGE_MAX_PIXELS:
+                raise ValueError('%dx%d exceeds LED_IMAGE_MAX_PIXELS (%d), the firmware rejects it'
+                                 % (width, height, imgconv.LED_IMAGE_MAX_PIXELS))
+        except (OSError, ValueError, IndexError) as e:
+            print('%s: %s' % (path, e), file=sys.stderr)
+            return 1
+
+        if any(n == name for n, *_ in images):
+            print('%s: duplicate name %s, skipped' % (path, name), file=sys.stderr)
+            continue
+
+        images.append((name, width, height, frames, durations))
+        print('%s: %dx%d, %d frame(s)' % (name, width, height, len(frames)))
+
+    pack = build_pack(images)
+
+    limit = partition_size()
+    if limit and len(pack) > limit:
+        print('Pack is %d bytes, the imgpack partition holds %d' % (len(pack), limit), file=sys.stderr)
+        return 1
+
+    with open(args.output, 'wb') as f:
+        f.write(pack)
+
+    print('%d images, %d bytes written to %s' % (len(images), len(pack), args.output))
+    return 0
+
+
+if __name__ == '__main__':
+    sys.exit(main())